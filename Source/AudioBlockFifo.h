@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    AudioBlockFifo.h
+
+    Bounded single-producer / single-consumer queue of audio blocks.
+
+    The slots are allocated up front and handed out in place, and
+    juce::AbstractFifo does the index bookkeeping with atomics, so pushing
+    and popping never allocate or lock. There is no event to signal either:
+    a side that finds the queue full or empty polls it, yielding at first
+    and then sleeping a millisecond at a time. The wait helpers report how
+    long they waited so callers can tell I/O stalls apart from processing
+    time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <thread>
+
+class AudioBlockFifo
+{
+public:
+    AudioBlockFifo(int numChannels, int blockSize, int numBlocks)
+        : fifo(numBlocks + 1), blockLengths(static_cast<size_t>(numBlocks + 1), 0)
+    {
+        // AbstractFifo keeps one slot free to tell full from empty
+        for (int i = 0; i <= numBlocks; ++i) {
+            blocks.emplace_back(numChannels, blockSize);
+        }
+    }
+
+    //==============================================================================
+    // producer side
+
+    // next free slot, or nullptr when the queue is full
+    juce::AudioBuffer<float>* getWriteBlock() {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        return size1 > 0 ? &blocks[static_cast<size_t>(start1)] : nullptr;
+    }
+
+    // publishes the slot returned by getWriteBlock() holding numSamples samples
+    void finishWrite(int numSamples) {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        jassert(size1 > 0);
+        blockLengths[static_cast<size_t>(start1)] = numSamples;
+        fifo.finishedWrite(1);
+    }
+
+    // no more blocks will be written
+    void markFinished() {
+        producerFinished = true;
+    }
+
+    juce::AudioBuffer<float>* waitForWriteBlock(const std::atomic<bool>& aborted, double& secondsWaited) {
+        auto* block = getWriteBlock();
+        if (block != nullptr) {
+            return block;
+        }
+
+        const auto waitStart = juce::Time::getHighResolutionTicks();
+        for (int attempt = 0; (block = getWriteBlock()) == nullptr && ! aborted; ++attempt) {
+            backOff(attempt);
+        }
+        secondsWaited += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - waitStart);
+
+        return aborted ? nullptr : block;
+    }
+
+    //==============================================================================
+    // consumer side
+
+    // oldest filled slot and its length, or nullptr when the queue is empty
+    juce::AudioBuffer<float>* getReadBlock(int& numSamples) {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+        if (size1 == 0) {
+            return nullptr;
+        }
+
+        numSamples = blockLengths[static_cast<size_t>(start1)];
+        return &blocks[static_cast<size_t>(start1)];
+    }
+
+    // hands the slot returned by getReadBlock() back to the producer
+    void finishRead() {
+        fifo.finishedRead(1);
+    }
+
+    // nullptr once the producer has finished and every block has been read
+    juce::AudioBuffer<float>* waitForReadBlock(int& numSamples, const std::atomic<bool>& aborted, double& secondsWaited) {
+        auto* block = getReadBlock(numSamples);
+        if (block != nullptr) {
+            return block;
+        }
+
+        const auto waitStart = juce::Time::getHighResolutionTicks();
+        for (int attempt = 0; ! aborted; ++attempt) {
+            // check the flag before the queue so a last block written just before it is not missed
+            const bool finished = producerFinished;
+            if ((block = getReadBlock(numSamples)) != nullptr || finished) {
+                break;
+            }
+            backOff(attempt);
+        }
+        secondsWaited += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - waitStart);
+
+        return aborted ? nullptr : block;
+    }
+
+private:
+    // polls that only yield before the waiting side starts sleeping
+    static constexpr int yieldAttempts = 64;
+
+    static void backOff(int attempt) {
+        if (attempt < yieldAttempts) {
+            std::this_thread::yield();
+        } else {
+            juce::Thread::sleep(1);
+        }
+    }
+
+    juce::AbstractFifo fifo;
+    std::vector<juce::AudioBuffer<float>> blocks;
+    std::vector<int> blockLengths;
+    std::atomic<bool> producerFinished { false };
+
+    JUCE_DECLARE_NON_COPYABLE (AudioBlockFifo)
+};
@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    BatchedReverb.cpp
+
+  ==============================================================================
+*/
+
+#include "BatchedReverb.h"
+
+namespace {
+
+// b0, b1, b2, a1, a2
+const int FILTER_COEFFICIENTS = 5;
+
+}
+
+BatchedReverb::BatchedReverb(int numLanesToUse)
+    : numLanes(juce::jmax(1, numLanesToUse)),
+      gains(static_cast<size_t>(numLanes), 0.0f),
+      wetLevels(static_cast<size_t>(numLanes), 0.0f),
+      dryLevels(static_cast<size_t>(numLanes), 0.0f),
+      earlyReflections(static_cast<size_t>(numLanes), 0.0f),
+      feedbackGains(static_cast<size_t>(numLanes), 0.0f),
+      damping(static_cast<size_t>(numLanes), 0.0f),
+      dampingFreqs(static_cast<size_t>(numLanes), 0.0f),
+      diffusionSteps(static_cast<size_t>(numLanes), 0),
+      diffusionGains(static_cast<size_t>(MAX_DIFFUSION_STEPS * numLanes), 0.0f),
+      dampingCoefficients(static_cast<size_t>(FILTER_COEFFICIENTS * numLanes), 0.0f),
+      dampingState(static_cast<size_t>(2 * KERNEL_CHANNELS * numLanes), 0.0f)
+{
+    // b0 = 1, everything else 0
+    std::fill(dampingCoefficients.begin(), dampingCoefficients.begin() + numLanes, 1.0f);
+}
+
+void BatchedReverb::prepare(double newSampleRate, int newMaximumBlockSize) {
+    sampleRate = newSampleRate;
+    maximumBlockSize = newMaximumBlockSize;
+
+    // 1 sec delay buffer, like the processor's
+    delayBufferFrames = maximumBlockSize + sampleRate;
+
+    multiChannelBuffer.setSize(KERNEL_CHANNELS, maximumBlockSize * numLanes);
+    multiChannelDiffusedBuffer.setSize(KERNEL_CHANNELS, maximumBlockSize * numLanes);
+    multiChannelDiffusedBufferHelper.setSize(KERNEL_CHANNELS, maximumBlockSize * numLanes);
+    multiChannelDelayBuffer.setSize(KERNEL_CHANNELS, delayBufferFrames * numLanes);
+    multiChannelDiffusedDelayBuffer.setSize(KERNEL_CHANNELS, delayBufferFrames * numLanes);
+
+    topology.prepare(sampleRate, topologySeed);
+    topology.getFeedbackLengths(delayLength, feedbackLengths);
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        updateDampingCoefficients(lane);
+    }
+
+    reset();
+}
+
+void BatchedReverb::reset() {
+    multiChannelDelayBuffer.clear();
+    multiChannelDiffusedDelayBuffer.clear();
+    std::fill(dampingState.begin(), dampingState.end(), 0.0f);
+    writePosition = 0;
+}
+
+void BatchedReverb::setSettings(int lane, const Settings& settings) {
+    jassert(lane >= 0 && lane < numLanes);
+    const auto index = static_cast<size_t>(lane);
+
+    gains[index] = settings.gain;
+    wetLevels[index] = settings.wetLevel;
+    dryLevels[index] = settings.dryLevel;
+    earlyReflections[index] = settings.earlyReflections;
+    damping[index] = settings.damping;
+
+    // freeze holds the loop at full gain, as in the processor's feedbackDelay
+    feedbackGains[index] = settings.freezeMode ? 1.0f : settings.decay;
+
+    diffusionSteps[index] = juce::jlimit(0, MAX_DIFFUSION_STEPS, static_cast<int>(settings.diffusion));
+    for (int step = 0; step < MAX_DIFFUSION_STEPS; ++step) {
+        const float diffuseGain = 0.9 - ((step + 1) * 0.1); // decrease with each diffusion step
+        diffusionGains[static_cast<size_t>(step * numLanes + lane)] = step < diffusionSteps[index] ? diffuseGain : 0.0f;
+    }
+
+    if (! juce::approximatelyEqual(settings.dampingFreq, dampingFreqs[index])) {
+        dampingFreqs[index] = settings.dampingFreq;
+        updateDampingCoefficients(lane);
+    }
+
+    if (lane == 0) {
+        if (! juce::approximatelyEqual(settings.delayLength, delayLength)) {
+            delayLength = settings.delayLength;
+            topology.getFeedbackLengths(delayLength, feedbackLengths);
+        }
+        reverse = settings.reverse;
+    }
+}
+
+void BatchedReverb::updateDampingCoefficients(int lane) {
+    const float cutoff = dampingFreqs[static_cast<size_t>(lane)];
+    if (cutoff <= 0) {
+        return;
+    }
+
+    const auto coefficients = juce::IIRCoefficients::makeLowPass(sampleRate, cutoff);
+    for (int k = 0; k < FILTER_COEFFICIENTS; ++k) {
+        dampingCoefficients[static_cast<size_t>(k * numLanes + lane)] = coefficients.coefficients[k];
+    }
+}
+
+void BatchedReverb::process(juce::AudioBuffer<float>& stems) {
+    jassert(stems.getNumChannels() >= 2 * numLanes);
+    jassert(stems.getNumSamples() <= maximumBlockSize);
+
+    const int numFrames = stems.getNumSamples();
+    const int numSamples = numFrames * numLanes;
+
+    // interleave the stems, lines 0 and 2 take the left channel, 1 and 3 the right
+    for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+        float* lineData = multiChannelBuffer.getWritePointer(line);
+        for (int lane = 0; lane < numLanes; ++lane) {
+            const float* stemData = stems.getReadPointer(2 * lane + line % 2);
+            for (int n = 0; n < numFrames; ++n) {
+                lineData[n * numLanes + lane] = stemData[n];
+            }
+        }
+
+        if (reverse) {
+            for (int front = 0, back = numFrames - 1; front < back; ++front, --back) {
+                std::swap_ranges(lineData + front * numLanes, lineData + (front + 1) * numLanes, lineData + back * numLanes);
+            }
+        }
+
+        multiChannelDiffusedBuffer.copyFrom(line, 0, lineData, numSamples);
+    }
+
+    fillDelayBuffer(multiChannelDelayBuffer, multiChannelBuffer, numFrames);
+
+    float** bufferDataArr = multiChannelBuffer.getArrayOfWritePointers();
+    float** diffusedBufferDataArr = multiChannelDiffusedBuffer.getArrayOfWritePointers();
+    float** diffusedBufferHelperDataArr = multiChannelDiffusedBufferHelper.getArrayOfWritePointers();
+    float** diffusedDelayBufferDataArr = multiChannelDiffusedDelayBuffer.getArrayOfWritePointers();
+
+    // diffuse the signal, lanes with fewer steps add the extra ones with a gain of 0
+    const int numSteps = *std::max_element(diffusionSteps.begin(), diffusionSteps.end());
+    for (int step = 0; step < numSteps; ++step) {
+        diffuseBuffer(numFrames, topology.diffusionReadOffsets[step]);
+
+        for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+            kernels.addWithLaneGains(diffusedBufferDataArr[line], diffusedBufferHelperDataArr[line], numFrames, numLanes, diffusionGains.data() + step * numLanes);
+        }
+    }
+
+    kernels.dampingFilterLanes(diffusedBufferDataArr, numFrames, numLanes, dampingCoefficients.data(), dampingState.data(), damping.data());
+
+    fillDelayBuffer(multiChannelDiffusedDelayBuffer, multiChannelDiffusedBuffer, numFrames);
+
+    // add the feedback delay, in the same runs as the processor
+    const int shortestLength = *std::min_element(std::begin(feedbackLengths), std::end(feedbackLengths));
+    for (int i = 0; i < numFrames;) {
+        const int writePosition_ = (writePosition + i) % delayBufferFrames;
+        int runLength = juce::jmin(numFrames - i, delayBufferFrames - writePosition_, shortestLength);
+
+        const float* delayedDataArr[KERNEL_CHANNELS];
+        for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+            const int readPosition_ = (writePosition_ + delayBufferFrames - feedbackLengths[line]) % delayBufferFrames;
+            runLength = juce::jmin(runLength, delayBufferFrames - readPosition_);
+            delayedDataArr[line] = diffusedDelayBufferDataArr[line] + readPosition_ * numLanes;
+        }
+
+        kernels.mixMatrix(delayedDataArr, 0, bufferDataArr, i * numLanes, runLength * numLanes,
+                          topology.householderMatrix.getRawDataPointer(), 0.8f);
+        for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+            kernels.addWithLaneGains(diffusedDelayBufferDataArr[line] + writePosition_ * numLanes, bufferDataArr[line] + i * numLanes,
+                                     runLength, numLanes, feedbackGains.data());
+        }
+
+        i += runLength;
+    }
+
+    // condense the lines back into the stems with every lane's own levels
+    const float gainDivisor = 2.0f / KERNEL_CHANNELS;
+    for (int lane = 0; lane < numLanes; ++lane) {
+        const auto laneIndex = static_cast<size_t>(lane);
+        const float wet = wetLevels[laneIndex] * 0.8f * gainDivisor;
+        const float early = earlyReflections[laneIndex];
+        const float dry = dryLevels[laneIndex];
+        const float gain = gains[laneIndex];
+
+        for (int channel = 0; channel < 2; ++channel) {
+            float* stemData = stems.getWritePointer(2 * lane + channel);
+            for (int n = 0; n < numFrames; ++n) {
+                const int index = n * numLanes + lane;
+                float sum = dry * stemData[n];
+                for (int line = channel; line < KERNEL_CHANNELS; line += 2) {
+                    sum += wet * bufferDataArr[line][index] + early * diffusedBufferDataArr[line][index];
+                }
+                stemData[n] = gain * sum;
+            }
+        }
+    }
+
+    // advance write head
+    writePosition += numFrames;
+    writePosition %= delayBufferFrames;
+}
+
+void BatchedReverb::fillDelayBuffer(juce::AudioBuffer<float>& delayBuffer, const juce::AudioBuffer<float>& source, const int numFrames) {
+    for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+        const float* sourceData = source.getReadPointer(line);
+        float* delayData = delayBuffer.getWritePointer(line);
+
+        if (delayBufferFrames > numFrames + writePosition) {
+            kernels.copyWithGain(delayData + writePosition * numLanes, sourceData, numFrames * numLanes, 0.8f);
+        } else {
+            const int framesRemaining = delayBufferFrames - writePosition;
+            kernels.copyWithGain(delayData + writePosition * numLanes, sourceData, framesRemaining * numLanes, 0.8f);
+            kernels.copyWithGain(delayData, sourceData + framesRemaining * numLanes, (numFrames - framesRemaining) * numLanes, 0.8f);
+        }
+    }
+}
+
+void BatchedReverb::diffuseBuffer(const int numFrames, const int* readOffsets) {
+    float** helperDataArr = multiChannelDiffusedBufferHelper.getArrayOfWritePointers();
+
+    for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+        const float* delayData = multiChannelDelayBuffer.getReadPointer(line);
+        const int readPosition = (writePosition + delayBufferFrames - readOffsets[line]) % delayBufferFrames;
+        const int firstPart = juce::jmin(numFrames, delayBufferFrames - readPosition);
+        kernels.copyWithGain(helperDataArr[line], delayData + readPosition * numLanes, firstPart * numLanes, 1.0f);
+        kernels.copyWithGain(helperDataArr[line] + firstPart * numLanes, delayData, (numFrames - firstPart) * numLanes, 1.0f);
+    }
+
+    // mix with permutation matrix, then hadamard matrix
+    kernels.mixMatrix(helperDataArr, 0, helperDataArr, 0, numFrames * numLanes, topology.diffusionMatrix.getRawDataPointer(), 1.0f);
+}
+
+//==============================================================================
+BatchedReverbProcessor::BatchedReverbProcessor(int numLanes)
+    : AudioProcessor(BusesProperties()
+                         .withInput("Input", juce::AudioChannelSet::discreteChannels(2 * juce::jmax(1, numLanes)), true)
+                         .withOutput("Output", juce::AudioChannelSet::discreteChannels(2 * juce::jmax(1, numLanes)), true)),
+      reverb(numLanes)
+{
+}
+
+void BatchedReverbProcessor::setSettings(const Settings& settings) {
+    for (int lane = 0; lane < reverb.getNumLanes(); ++lane) {
+        reverb.setSettings(lane, settings);
+    }
+}
+
+void BatchedReverbProcessor::setLaneSettings(int lane, const Settings& settings) {
+    reverb.setSettings(lane, settings);
+}
+
+void BatchedReverbProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
+    reverb.prepare(sampleRate, samplesPerBlock);
+}
+
+void BatchedReverbProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) {
+    juce::ScopedNoDenormals noDenormals;
+    reverb.process(buffer);
+}
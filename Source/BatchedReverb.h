@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    BatchedReverb.h
+
+    "My Reverb" for many stereo stems at once. Every stem is a lane and the
+    lanes are interleaved sample by sample, so the kernels see one long run
+    per line and work on all stems with each instruction instead of running
+    one processor per stem. The lanes share one ReverbTopology and keep
+    their own parameters, stored per parameter as arrays over the lanes.
+
+    4, 8 or 16 lanes fill whole SSE / AVX2 / AVX-512 registers, other counts
+    work but run the per-lane parameter kernels as plain loops.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+#include "PluginProcessor.h"
+#include "ReverbTopology.h"
+
+class BatchedReverb
+{
+public:
+    explicit BatchedReverb(int numLanes);
+
+    int getNumLanes() const { return numLanes; }
+
+    // seed for the shared delay network, used from the next prepare
+    void setTopologySeed(juce::int64 seed) { topologySeed = seed; }
+
+    void prepare(double sampleRate, int maximumBlockSize);
+    void reset();
+
+    // mode, roomSize and width belong to the basic reverb and are ignored.
+    // delayLength and reverse shape the network all lanes run through, so
+    // they are taken from lane 0
+    void setSettings(int lane, const Settings& settings);
+
+    // stems holds 2 * getNumLanes() channels, lane l is channels 2l (left) and 2l + 1 (right)
+    void process(juce::AudioBuffer<float>& stems);
+
+private:
+    void updateDampingCoefficients(int lane);
+    void fillDelayBuffer(juce::AudioBuffer<float>& delayBuffer, const juce::AudioBuffer<float>& source, const int numFrames);
+    void diffuseBuffer(const int numFrames, const int* readOffsets);
+
+    const int numLanes;
+    double sampleRate { 44100 };
+    int maximumBlockSize { 0 };
+
+    ReverbTopology topology;
+    juce::int64 topologySeed { DEFAULT_TOPOLOGY_SEED };
+    int feedbackLengths[KERNEL_CHANNELS] {};
+
+    // lane-interleaved lines, frame n of lane l at [n * numLanes + l]
+    juce::AudioBuffer<float> multiChannelBuffer;
+    juce::AudioBuffer<float> multiChannelDiffusedBuffer;
+    juce::AudioBuffer<float> multiChannelDiffusedBufferHelper;
+    juce::AudioBuffer<float> multiChannelDelayBuffer;
+    juce::AudioBuffer<float> multiChannelDiffusedDelayBuffer;
+    int delayBufferFrames { 0 };
+    int writePosition { 0 };
+
+    // per-lane parameters, one entry per lane
+    std::vector<float> gains;
+    std::vector<float> wetLevels;
+    std::vector<float> dryLevels;
+    std::vector<float> earlyReflections;
+    std::vector<float> feedbackGains;
+    std::vector<float> damping;
+    std::vector<float> dampingFreqs;
+    std::vector<int> diffusionSteps;
+    // numLanes entries per diffusion step, 0 for lanes with fewer steps
+    std::vector<float> diffusionGains;
+    // b0, b1, b2, a1, a2 over the lanes, and the filter state (see DSPKernels::dampingFilterLanes)
+    // a lane without a cutoff yet passes through unfiltered
+    std::vector<float> dampingCoefficients;
+    std::vector<float> dampingState;
+
+    float delayLength { 0 };
+    bool reverse { false };
+
+    const DSPKernels& kernels { getDSPKernels() };
+
+    JUCE_DECLARE_NON_COPYABLE (BatchedReverb)
+};
+
+// BatchedReverb as a processor with 2 * numLanes discrete channels in and out,
+// so StreamingRenderer can run it over a multichannel stem file
+class BatchedReverbProcessor  : public juce::AudioProcessor
+{
+public:
+    explicit BatchedReverbProcessor(int numLanes);
+
+    int getNumLanes() const { return reverb.getNumLanes(); }
+
+    // not thread safe against processBlock, set everything up before rendering
+    void setSettings(const Settings& settings);
+    void setLaneSettings(int lane, const Settings& settings);
+    void setTopologySeed(juce::int64 seed) { reverb.setTopologySeed(seed); }
+
+    //==============================================================================
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override;
+
+    //==============================================================================
+    const juce::String getName() const override { return "BatchedReverb"; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    double getTailLengthSeconds() const override { return 0.0; }
+
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    BatchedReverb reverb;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BatchedReverbProcessor)
+};
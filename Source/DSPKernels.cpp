@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    DSPKernels.cpp
+
+    Portable kernels and the runtime dispatch between instruction sets.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+#if defined(_MSC_VER) && ! defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+void mixMatrixGeneric(const float* const* source, int sourceStart, float* const* dest, int destStart, int numSamples, const float* matrix, float gain) {
+    for (int n = 0; n < numSamples; ++n) {
+        float in[KERNEL_CHANNELS];
+        for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+            in[k] = source[k][sourceStart + n];
+        }
+        for (int j = 0; j < KERNEL_CHANNELS; ++j) {
+            float sum = 0;
+            for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+                sum += in[k] * matrix[k * KERNEL_CHANNELS + j];
+            }
+            dest[j][destStart + n] = sum * gain;
+        }
+    }
+}
+
+void copyWithGainGeneric(float* dest, const float* source, int numSamples, float gain) {
+    for (int n = 0; n < numSamples; ++n) {
+        dest[n] = source[n] * gain;
+    }
+}
+
+void addWithGainGeneric(float* dest, const float* source, int numSamples, float gain) {
+    for (int n = 0; n < numSamples; ++n) {
+        dest[n] += source[n] * gain;
+    }
+}
+
+void dampingFilterGeneric(float* const* data, int numSamples, const float* coefficients, float* state, float damping) {
+    const float b0 = coefficients[0], b1 = coefficients[1], b2 = coefficients[2];
+    const float a1 = coefficients[3], a2 = coefficients[4];
+
+    for (int channel = 0; channel < KERNEL_CHANNELS; ++channel) {
+        float* samples = data[channel];
+        float v1 = state[channel];
+        float v2 = state[KERNEL_CHANNELS + channel];
+
+        for (int n = 0; n < numSamples; ++n) {
+            const float in = samples[n];
+            const float out = b0 * in + v1;
+            v1 = b1 * in - a1 * out + v2;
+            v2 = b2 * in - a2 * out;
+            samples[n] = (1 - damping) * in + damping * out;
+        }
+
+        state[channel] = v1;
+        state[KERNEL_CHANNELS + channel] = v2;
+    }
+}
+
+#include "DSPLaneKernels.inl"
+
+const DSPKernels genericKernels {
+    "generic",
+    mixMatrixGeneric,
+    copyWithGainGeneric,
+    addWithGainGeneric,
+    dampingFilterGeneric,
+    addWithLaneGainsLoop,
+    dampingFilterLanesLoop
+};
+
+// XCR0 bits the OS sets for the registers it saves on a context switch
+const juce::uint64 XCR0_AVX_STATE = 0x6;     // XMM, YMM
+const juce::uint64 XCR0_AVX512_STATE = 0xe6; // XMM, YMM, opmask, both halves of ZMM
+
+// XCR0, or 0 where it can't be read. juce::SystemStats only reports the CPUID
+// feature bits; a VM or kernel can still leave the YMM / ZMM registers off, and
+// the first AVX instruction then raises SIGILL
+juce::uint64 getEnabledRegisterState() {
+#if defined(_MSC_VER) && ! defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+    int info[4];
+    __cpuid(info, 1);
+    // xgetbv itself faults unless the OS has set OSXSAVE
+    if ((info[2] & (1 << 27)) == 0) {
+        return 0;
+    }
+    return _xgetbv(0);
+#elif defined(__i386__) || defined(__x86_64__)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 || (ecx & bit_OSXSAVE) == 0) {
+        return 0;
+    }
+    unsigned int low = 0, high = 0;
+    __asm__ volatile ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+    return (static_cast<juce::uint64>(high) << 32) | low;
+#else
+    return 0;
+#endif
+}
+
+void overlayKernels(DSPKernels& kernels, const DSPKernels* isaKernels) {
+    if (isaKernels == nullptr) {
+        return;
+    }
+
+    kernels.name = isaKernels->name;
+    if (isaKernels->mixMatrix != nullptr) kernels.mixMatrix = isaKernels->mixMatrix;
+    if (isaKernels->copyWithGain != nullptr) kernels.copyWithGain = isaKernels->copyWithGain;
+    if (isaKernels->addWithGain != nullptr) kernels.addWithGain = isaKernels->addWithGain;
+    if (isaKernels->dampingFilter != nullptr) kernels.dampingFilter = isaKernels->dampingFilter;
+    if (isaKernels->addWithLaneGains != nullptr) kernels.addWithLaneGains = isaKernels->addWithLaneGains;
+    if (isaKernels->dampingFilterLanes != nullptr) kernels.dampingFilterLanes = isaKernels->dampingFilterLanes;
+}
+
+}
+
+const DSPKernels& getDSPKernels() {
+    static const DSPKernels kernels = [] {
+        DSPKernels best = genericKernels;
+
+        if (juce::SystemStats::hasSSE2()) {
+            overlayKernels(best, getSSE2Kernels());
+        }
+        const juce::uint64 registerState = getEnabledRegisterState();
+
+        if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3()
+            && (registerState & XCR0_AVX_STATE) == XCR0_AVX_STATE) {
+            overlayKernels(best, getAVX2Kernels());
+        }
+        if (juce::SystemStats::hasAVX512F()
+            && (registerState & XCR0_AVX512_STATE) == XCR0_AVX512_STATE) {
+            overlayKernels(best, getAVX512Kernels());
+        }
+
+        return best;
+    }();
+
+    return kernels;
+}
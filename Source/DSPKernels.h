@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    DSPKernels.h
+
+    The hot inner loops of "My Reverb", compiled once per instruction set
+    and picked at runtime from the CPU's feature flags.
+
+    Nothing in here may include JUCE (or any other header with inline code):
+    the ISA-specific translation units are built with -mavx2 / -mavx512f, and
+    inline functions emitted there could otherwise be merged into callers
+    running on older CPUs.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// number of lines every kernel works on, matches MULTICHANNEL_TOTAL_INPUTS
+const int KERNEL_CHANNELS = 4;
+
+struct DSPKernels {
+    const char* name;
+
+    // dest[j][n] = gain * sum_k source[k][n] * matrix[k * KERNEL_CHANNELS + j]
+    // matrix is row-major, source and dest must either be the same samples or not overlap
+    void (*mixMatrix) (const float* const* source, int sourceStart,
+                       float* const* dest, int destStart,
+                       int numSamples, const float* matrix, float gain);
+
+    // dest[n] = source[n] * gain
+    void (*copyWithGain) (float* dest, const float* source, int numSamples, float gain);
+
+    // dest[n] += source[n] * gain
+    void (*addWithGain) (float* dest, const float* source, int numSamples, float gain);
+
+    // in place: x = (1 - damping) * x + damping * lowpass(x) on every line
+    // coefficients are juce::IIRCoefficients::coefficients (b0, b1, b2, a1, a2)
+    // state holds the two filter state variables of every line: v1[KERNEL_CHANNELS], v2[KERNEL_CHANNELS]
+    void (*dampingFilter) (float* const* data, int numSamples,
+                           const float* coefficients, float* state, float damping);
+
+    // lane-interleaved versions for BatchedReverb, sample n of lane l is at [n * numLanes + l]
+    // (the kernels above work on such data as-is when every lane shares the gains, so
+    // they must round a sample the same way wherever it falls in the run, tails included)
+
+    // dest[n][l] += source[n][l] * gains[l]
+    void (*addWithLaneGains) (float* dest, const float* source, int numFrames, int numLanes, const float* gains);
+
+    // dampingFilter with per-lane settings:
+    // coefficients holds b0[numLanes], b1[numLanes], b2[numLanes], a1[numLanes], a2[numLanes]
+    // state holds v1[numLanes], v2[numLanes] for each line in turn
+    void (*dampingFilterLanes) (float* const* data, int numFrames, int numLanes,
+                                const float* coefficients, float* state, const float* damping);
+};
+
+// best kernels this CPU supports and the OS has enabled the registers for, chosen on first use
+const DSPKernels& getDSPKernels();
+
+// per-ISA tables, nullptr when the translation unit was built without that ISA
+// entries left nullptr fall back to the next lower level
+const DSPKernels* getSSE2Kernels();
+const DSPKernels* getAVX2Kernels();
+const DSPKernels* getAVX512Kernels();
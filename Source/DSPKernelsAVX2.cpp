@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    DSPKernelsAVX2.cpp
+
+    AVX2 + FMA kernels, 8 samples per register. Built with -mavx2 -mfma, or
+    /arch:AVX2 on MSVC, which allows FMA without defining __FMA__ (see
+    CMakeLists.txt); without those flags this file only provides the
+    nullptr table. The damping filter has nothing to gain from 8 lanes with
+    four lines, so it stays on the SSE2 version.
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+namespace {
+
+// a * b + c rounded once, for the tails. Not std::fma: its out-of-line copy from
+// this file could end up serving callers on CPUs without FMA (see DSPKernels.h)
+float fmaScalar(float a, float b, float c) {
+    return _mm_cvtss_f32(_mm_fmadd_ss(_mm_set_ss(a), _mm_set_ss(b), _mm_set_ss(c)));
+}
+
+void mixMatrixAVX2(const float* const* source, int sourceStart, float* const* dest, int destStart, int numSamples, const float* matrix, float gain) {
+    // the tail repeats the vector loop's multiplies and FMAs on scaled (see DSPKernels.h)
+    float scaled[KERNEL_CHANNELS * KERNEL_CHANNELS];
+    __m256 m[KERNEL_CHANNELS * KERNEL_CHANNELS];
+    for (int i = 0; i < KERNEL_CHANNELS * KERNEL_CHANNELS; ++i) {
+        scaled[i] = matrix[i] * gain;
+        m[i] = _mm256_set1_ps(scaled[i]);
+    }
+
+    const float* in[KERNEL_CHANNELS];
+    float* out[KERNEL_CHANNELS];
+    for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+        in[k] = source[k] + sourceStart;
+        out[k] = dest[k] + destStart;
+    }
+
+    int n = 0;
+    for (; n + 8 <= numSamples; n += 8) {
+        // load every line before storing any, so mixing in place is safe
+        __m256 x[KERNEL_CHANNELS];
+        for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+            x[k] = _mm256_loadu_ps(in[k] + n);
+        }
+        for (int j = 0; j < KERNEL_CHANNELS; ++j) {
+            __m256 sum = _mm256_mul_ps(x[0], m[j]);
+            for (int k = 1; k < KERNEL_CHANNELS; ++k) {
+                sum = _mm256_fmadd_ps(x[k], m[k * KERNEL_CHANNELS + j], sum);
+            }
+            _mm256_storeu_ps(out[j] + n, sum);
+        }
+    }
+
+    for (; n < numSamples; ++n) {
+        float x[KERNEL_CHANNELS];
+        for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+            x[k] = in[k][n];
+        }
+        for (int j = 0; j < KERNEL_CHANNELS; ++j) {
+            float sum = x[0] * scaled[j];
+            for (int k = 1; k < KERNEL_CHANNELS; ++k) {
+                sum = fmaScalar(x[k], scaled[k * KERNEL_CHANNELS + j], sum);
+            }
+            out[j][n] = sum;
+        }
+    }
+}
+
+void copyWithGainAVX2(float* dest, const float* source, int numSamples, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    int n = 0;
+    for (; n + 8 <= numSamples; n += 8) {
+        _mm256_storeu_ps(dest + n, _mm256_mul_ps(_mm256_loadu_ps(source + n), g));
+    }
+    for (; n < numSamples; ++n) {
+        dest[n] = source[n] * gain;
+    }
+}
+
+void addWithGainAVX2(float* dest, const float* source, int numSamples, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    int n = 0;
+    for (; n + 8 <= numSamples; n += 8) {
+        _mm256_storeu_ps(dest + n, _mm256_fmadd_ps(_mm256_loadu_ps(source + n), g, _mm256_loadu_ps(dest + n)));
+    }
+    for (; n < numSamples; ++n) {
+        dest[n] = fmaScalar(source[n], gain, dest[n]);
+    }
+}
+
+// the same loops as the generic build, vectorised 8 lanes at a time
+#include "DSPLaneKernels.inl"
+
+const DSPKernels avx2Kernels {
+    "AVX2",
+    mixMatrixAVX2,
+    copyWithGainAVX2,
+    addWithGainAVX2,
+    nullptr,
+    addWithLaneGainsLoop,
+    dampingFilterLanesLoop
+};
+
+}
+
+const DSPKernels* getAVX2Kernels() {
+    return &avx2Kernels;
+}
+
+#else
+
+const DSPKernels* getAVX2Kernels() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    DSPKernelsAVX512.cpp
+
+    AVX-512F kernels, 16 samples per register with masked tails. Built with
+    -mavx512f -mfma (see CMakeLists.txt); without those flags this file only
+    provides the nullptr table.
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace {
+
+__mmask16 tailMask(int remaining) {
+    return static_cast<__mmask16>((1u << remaining) - 1);
+}
+
+void mixMatrixAVX512(const float* const* source, int sourceStart, float* const* dest, int destStart, int numSamples, const float* matrix, float gain) {
+    __m512 m[KERNEL_CHANNELS * KERNEL_CHANNELS];
+    for (int i = 0; i < KERNEL_CHANNELS * KERNEL_CHANNELS; ++i) {
+        m[i] = _mm512_set1_ps(matrix[i] * gain);
+    }
+
+    const float* in[KERNEL_CHANNELS];
+    float* out[KERNEL_CHANNELS];
+    for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+        in[k] = source[k] + sourceStart;
+        out[k] = dest[k] + destStart;
+    }
+
+    for (int n = 0; n < numSamples; n += 16) {
+        const __mmask16 mask = numSamples - n >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(numSamples - n);
+
+        // load every line before storing any, so mixing in place is safe
+        __m512 x[KERNEL_CHANNELS];
+        for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+            x[k] = _mm512_maskz_loadu_ps(mask, in[k] + n);
+        }
+        for (int j = 0; j < KERNEL_CHANNELS; ++j) {
+            __m512 sum = _mm512_mul_ps(x[0], m[j]);
+            for (int k = 1; k < KERNEL_CHANNELS; ++k) {
+                sum = _mm512_fmadd_ps(x[k], m[k * KERNEL_CHANNELS + j], sum);
+            }
+            _mm512_mask_storeu_ps(out[j] + n, mask, sum);
+        }
+    }
+}
+
+void copyWithGainAVX512(float* dest, const float* source, int numSamples, float gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    for (int n = 0; n < numSamples; n += 16) {
+        const __mmask16 mask = numSamples - n >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(numSamples - n);
+        _mm512_mask_storeu_ps(dest + n, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, source + n), g));
+    }
+}
+
+void addWithGainAVX512(float* dest, const float* source, int numSamples, float gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    for (int n = 0; n < numSamples; n += 16) {
+        const __mmask16 mask = numSamples - n >= 16 ? static_cast<__mmask16>(0xffff) : tailMask(numSamples - n);
+        const __m512 sum = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, source + n), g, _mm512_maskz_loadu_ps(mask, dest + n));
+        _mm512_mask_storeu_ps(dest + n, mask, sum);
+    }
+}
+
+// the same loops as the generic build, vectorised 16 lanes at a time
+#include "DSPLaneKernels.inl"
+
+const DSPKernels avx512Kernels {
+    "AVX-512",
+    mixMatrixAVX512,
+    copyWithGainAVX512,
+    addWithGainAVX512,
+    nullptr,
+    addWithLaneGainsLoop,
+    dampingFilterLanesLoop
+};
+
+}
+
+const DSPKernels* getAVX512Kernels() {
+    return &avx512Kernels;
+}
+
+#else
+
+const DSPKernels* getAVX512Kernels() {
+    return nullptr;
+}
+
+#endif
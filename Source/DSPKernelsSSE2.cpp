@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    DSPKernelsSSE2.cpp
+
+    SSE2 kernels. Every x86-64 CPU has these, so this is the baseline there.
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+namespace {
+
+void mixMatrixSSE2(const float* const* source, int sourceStart, float* const* dest, int destStart, int numSamples, const float* matrix, float gain) {
+    // scaled is for the tail, which must round exactly like the vector loop (see DSPKernels.h)
+    float scaled[KERNEL_CHANNELS * KERNEL_CHANNELS];
+    __m128 m[KERNEL_CHANNELS * KERNEL_CHANNELS];
+    for (int i = 0; i < KERNEL_CHANNELS * KERNEL_CHANNELS; ++i) {
+        scaled[i] = matrix[i] * gain;
+        m[i] = _mm_set1_ps(scaled[i]);
+    }
+
+    const float* in[KERNEL_CHANNELS];
+    float* out[KERNEL_CHANNELS];
+    for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+        in[k] = source[k] + sourceStart;
+        out[k] = dest[k] + destStart;
+    }
+
+    int n = 0;
+    for (; n + 4 <= numSamples; n += 4) {
+        // load every line before storing any, so mixing in place is safe
+        __m128 x[KERNEL_CHANNELS];
+        for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+            x[k] = _mm_loadu_ps(in[k] + n);
+        }
+        for (int j = 0; j < KERNEL_CHANNELS; ++j) {
+            __m128 sum = _mm_mul_ps(x[0], m[j]);
+            for (int k = 1; k < KERNEL_CHANNELS; ++k) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(x[k], m[k * KERNEL_CHANNELS + j]));
+            }
+            _mm_storeu_ps(out[j] + n, sum);
+        }
+    }
+
+    for (; n < numSamples; ++n) {
+        float x[KERNEL_CHANNELS];
+        for (int k = 0; k < KERNEL_CHANNELS; ++k) {
+            x[k] = in[k][n];
+        }
+        for (int j = 0; j < KERNEL_CHANNELS; ++j) {
+            float sum = x[0] * scaled[j];
+            for (int k = 1; k < KERNEL_CHANNELS; ++k) {
+                sum += x[k] * scaled[k * KERNEL_CHANNELS + j];
+            }
+            out[j][n] = sum;
+        }
+    }
+}
+
+void copyWithGainSSE2(float* dest, const float* source, int numSamples, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    int n = 0;
+    for (; n + 4 <= numSamples; n += 4) {
+        _mm_storeu_ps(dest + n, _mm_mul_ps(_mm_loadu_ps(source + n), g));
+    }
+    for (; n < numSamples; ++n) {
+        dest[n] = source[n] * gain;
+    }
+}
+
+void addWithGainSSE2(float* dest, const float* source, int numSamples, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    int n = 0;
+    for (; n + 4 <= numSamples; n += 4) {
+        const __m128 sum = _mm_add_ps(_mm_loadu_ps(dest + n), _mm_mul_ps(_mm_loadu_ps(source + n), g));
+        _mm_storeu_ps(dest + n, sum);
+    }
+    for (; n < numSamples; ++n) {
+        dest[n] += source[n] * gain;
+    }
+}
+
+// the filter is recursive in time, so the four lines run side by side in one register
+static_assert(KERNEL_CHANNELS == 4, "dampingFilterSSE2 maps one line to each SSE lane");
+
+void dampingFilterSSE2(float* const* data, int numSamples, const float* coefficients, float* state, float damping) {
+    const __m128 b0 = _mm_set1_ps(coefficients[0]);
+    const __m128 b1 = _mm_set1_ps(coefficients[1]);
+    const __m128 b2 = _mm_set1_ps(coefficients[2]);
+    const __m128 a1 = _mm_set1_ps(coefficients[3]);
+    const __m128 a2 = _mm_set1_ps(coefficients[4]);
+    const __m128 wet = _mm_set1_ps(damping);
+    const __m128 dry = _mm_set1_ps(1 - damping);
+
+    __m128 v1 = _mm_loadu_ps(state);
+    __m128 v2 = _mm_loadu_ps(state + KERNEL_CHANNELS);
+
+    float* d0 = data[0];
+    float* d1 = data[1];
+    float* d2 = data[2];
+    float* d3 = data[3];
+
+    alignas(16) float lanes[KERNEL_CHANNELS];
+    for (int n = 0; n < numSamples; ++n) {
+        const __m128 x = _mm_setr_ps(d0[n], d1[n], d2[n], d3[n]);
+        const __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), v1);
+        v1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), v2);
+        v2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+
+        _mm_store_ps(lanes, _mm_add_ps(_mm_mul_ps(dry, x), _mm_mul_ps(wet, y)));
+        d0[n] = lanes[0];
+        d1[n] = lanes[1];
+        d2[n] = lanes[2];
+        d3[n] = lanes[3];
+    }
+
+    _mm_storeu_ps(state, v1);
+    _mm_storeu_ps(state + KERNEL_CHANNELS, v2);
+}
+
+const DSPKernels sse2Kernels {
+    "SSE2",
+    mixMatrixSSE2,
+    copyWithGainSSE2,
+    addWithGainSSE2,
+    dampingFilterSSE2,
+    nullptr,
+    nullptr
+};
+
+}
+
+const DSPKernels* getSSE2Kernels() {
+    return &sse2Kernels;
+}
+
+#else
+
+const DSPKernels* getSSE2Kernels() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    DSPLaneKernels.inl
+
+    Kernels for lane-interleaved data (BatchedReverb): sample n of lane l is
+    stored at [n * numLanes + l], so one frame of all lanes is contiguous.
+
+    Plain loops over a compile-time lane count, which the compiler turns into
+    whole-register operations. This file is included inside an anonymous
+    namespace by DSPKernels.cpp and the AVX2 / AVX-512 kernel files, so the
+    same loops are built once per instruction set. It can't include headers
+    itself; size_t comes from the includer's <immintrin.h> or JuceHeader.h.
+
+  ==============================================================================
+*/
+
+template <size_t numLanes>
+void addWithLaneGainsFixed(float* dest, const float* source, int numFrames, const float* gains) {
+    float g[numLanes];
+    for (size_t l = 0; l < numLanes; ++l) {
+        g[l] = gains[l];
+    }
+
+    for (size_t n = 0; n < static_cast<size_t>(numFrames); ++n) {
+        float* d = dest + n * numLanes;
+        const float* s = source + n * numLanes;
+        for (size_t l = 0; l < numLanes; ++l) {
+            d[l] += s[l] * g[l];
+        }
+    }
+}
+
+void addWithLaneGainsLoop(float* dest, const float* source, int numFrames, int numLanes, const float* gains) {
+    switch (numLanes) {
+        case 4:  addWithLaneGainsFixed<4>(dest, source, numFrames, gains); break;
+        case 8:  addWithLaneGainsFixed<8>(dest, source, numFrames, gains); break;
+        case 16: addWithLaneGainsFixed<16>(dest, source, numFrames, gains); break;
+        default:
+            for (int n = 0; n < numFrames; ++n) {
+                for (int l = 0; l < numLanes; ++l) {
+                    dest[n * numLanes + l] += source[n * numLanes + l] * gains[l];
+                }
+            }
+            break;
+    }
+}
+
+template <size_t numLanes>
+void dampingFilterLanesFixed(float* const* data, int numFrames, const float* coefficients, float* state, const float* damping) {
+    float b0[numLanes], b1[numLanes], b2[numLanes], a1[numLanes], a2[numLanes];
+    float wet[numLanes], dry[numLanes];
+    for (size_t l = 0; l < numLanes; ++l) {
+        b0[l] = coefficients[0 * numLanes + l];
+        b1[l] = coefficients[1 * numLanes + l];
+        b2[l] = coefficients[2 * numLanes + l];
+        a1[l] = coefficients[3 * numLanes + l];
+        a2[l] = coefficients[4 * numLanes + l];
+        wet[l] = damping[l];
+        dry[l] = 1 - damping[l];
+    }
+
+    for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+        float* lineState = state + static_cast<size_t>(line) * 2 * numLanes;
+        float v1[numLanes], v2[numLanes];
+        for (size_t l = 0; l < numLanes; ++l) {
+            v1[l] = lineState[l];
+            v2[l] = lineState[numLanes + l];
+        }
+
+        for (size_t n = 0; n < static_cast<size_t>(numFrames); ++n) {
+            float* frame = data[line] + n * numLanes;
+            for (size_t l = 0; l < numLanes; ++l) {
+                const float in = frame[l];
+                const float out = b0[l] * in + v1[l];
+                v1[l] = b1[l] * in - a1[l] * out + v2[l];
+                v2[l] = b2[l] * in - a2[l] * out;
+                frame[l] = dry[l] * in + wet[l] * out;
+            }
+        }
+
+        for (size_t l = 0; l < numLanes; ++l) {
+            lineState[l] = v1[l];
+            lineState[numLanes + l] = v2[l];
+        }
+    }
+}
+
+void dampingFilterLanesLoop(float* const* data, int numFrames, int numLanes, const float* coefficients, float* state, const float* damping) {
+    switch (numLanes) {
+        case 4:  dampingFilterLanesFixed<4>(data, numFrames, coefficients, state, damping); break;
+        case 8:  dampingFilterLanesFixed<8>(data, numFrames, coefficients, state, damping); break;
+        case 16: dampingFilterLanesFixed<16>(data, numFrames, coefficients, state, damping); break;
+        default:
+            for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+                for (int l = 0; l < numLanes; ++l) {
+                    const float* c = coefficients + l;
+                    float& v1 = state[(line * 2) * numLanes + l];
+                    float& v2 = state[(line * 2 + 1) * numLanes + l];
+                    for (int n = 0; n < numFrames; ++n) {
+                        float& sample = data[line][n * numLanes + l];
+                        const float in = sample;
+                        const float out = c[0] * in + v1;
+                        v1 = c[numLanes] * in - c[3 * numLanes] * out + v2;
+                        v2 = c[2 * numLanes] * in - c[4 * numLanes] * out;
+                        sample = (1 - damping[l]) * in + damping[l] * out;
+                    }
+                }
+            }
+            break;
+    }
+}
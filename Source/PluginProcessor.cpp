@@ -105,7 +105,6 @@ void CompSoundFinalProjectAudioProcessor::prepareToPlay (double sampleRate, int
     processSpec.maximumBlockSize = samplesPerBlock;
     processSpec.numChannels = numInputChannels;
     
-    processorChain.prepare(processSpec);
     reverb.prepare(processSpec);
     
     settings = getSettings(apvts);
@@ -117,55 +116,31 @@ void CompSoundFinalProjectAudioProcessor::prepareToPlay (double sampleRate, int
     multiChannelBuffer.setSize(MULTICHANNEL_TOTAL_INPUTS, samplesPerBlock);
     multiChannelDiffusedBuffer.setSize(MULTICHANNEL_TOTAL_INPUTS, samplesPerBlock);
     multiChannelDiffusedBufferHelper.setSize(MULTICHANNEL_TOTAL_INPUTS, samplesPerBlock);
-    multiChannelDiffusedBufferLowPass.setSize(MULTICHANNEL_TOTAL_INPUTS, samplesPerBlock);
     multiChannelDelayBuffer.setSize(MULTICHANNEL_TOTAL_INPUTS, delayBufferLength);
     multiChannelDiffusedDelayBuffer.setSize(MULTICHANNEL_TOTAL_INPUTS, delayBufferLength);
 
-    // setting householder matrix
-    for (int i = 0; i < MATRIX_SIZE; i++) {
-        for (int j = 0; j < MATRIX_SIZE; j++) {
-            if (i == j) {
-                householderMatrix(i, j) = 0.5;
-            } else {
-                householderMatrix(i, j) = -0.5;
-            }
-        }
-    }
-    
-    // (tediously) setting hadamard matrix
-    for (int i = 0; i < MATRIX_SIZE; i++) {
-        for (int j = 0; j < MATRIX_SIZE; j++) {
-            if (i == 0 || j == 0 || (i == 3 && j == 3)
-                || (i == 1 && j == 2) || (i == 2 && j == 1)) {
-                hadamardMatrix(i, j) = 1;
-            } else {
-                hadamardMatrix(i, j) = -1;
-            }
-        }
-    }
-    
-    // setting permutation matrix
-    for (int i = 0; i < MATRIX_SIZE; i++) {
-        for (int j = 0; j < MATRIX_SIZE; j++) {
-            permutationMatrix(i, j) = 0;
-        }
-    }
-    // statically setting for now
-    permutationMatrix(0,3) = 1;
-    permutationMatrix(1,2) = -1;
-    permutationMatrix(2,0) = 1;
-    permutationMatrix(3,1) = -1;
-    
-    
-    // random delays for diffusion steps
-    for (int i = 0; i < MULTICHANNEL_TOTAL_INPUTS; ++i) {
-        diffuseDelays[i] = rand() % 20;
-    }
+    topology.prepare(sampleRate, topologySeed);
+    topology.getFeedbackLengths(settings.delayLength, feedbackLengths);
+    feedbackLengthsDelay = settings.delayLength;
     
     // setting lowpass filter
-    for (int channel = 0; channel < MULTICHANNEL_TOTAL_INPUTS; ++channel) {
-        lowPassFilters[channel].setCoefficients(juce::IIRCoefficients::makeLowPass(sampleRate, settings.dampingFreq));
+    dampingCoefficients = juce::IIRCoefficients::makeLowPass(sampleRate, settings.dampingFreq);
+    dampingCoefficientsFreq = settings.dampingFreq;
+    
+    // equal-power fade in curve, the fade out curve is the same table read backwards
+    const int crossfadeLength = juce::jmax(1, static_cast<int>(sampleRate * MODE_CROSSFADE_SECONDS));
+    crossfadeGains.resize(static_cast<size_t>(crossfadeLength) + 1);
+    for (size_t i = 0; i < crossfadeGains.size(); ++i) {
+        crossfadeGains[i] = std::sin(juce::MathConstants<float>::halfPi * static_cast<float>(i) / static_cast<float>(crossfadeLength));
     }
+    crossfadeBuffer.setSize(juce::jmax(numInputChannels, getTotalNumOutputChannels()), samplesPerBlock);
+    
+    // start from clean engines with only the selected one running
+    resetMode(0);
+    resetMode(1);
+    activeMode = settings.mode;
+    outgoingMode = -1;
+    crossfadeRemaining = 0;
 }
 
 void CompSoundFinalProjectAudioProcessor::releaseResources()
@@ -207,7 +182,6 @@ void CompSoundFinalProjectAudioProcessor::processBlock (juce::AudioBuffer<float>
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     
     const int bufferLength = buffer.getNumSamples();
-    const int delayBufferLength = multiChannelDelayBuffer.getNumSamples();
     
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
@@ -221,16 +195,48 @@ void CompSoundFinalProjectAudioProcessor::processBlock (juce::AudioBuffer<float>
     settings = getSettings(apvts);
     setReverbParameters();
     
-    if (settings.mode == 0) {
-        auto audioBlock = juce::dsp::AudioBlock<float>(buffer);
-        auto processContext = juce::dsp::ProcessContextReplacing<float>(audioBlock);
-        reverb.setParameters(reverbParams);
-        reverb.setEnabled(true);
-        reverb.process(processContext);
-        
-        return;
+    if (settings.mode != activeMode) {
+        switchMode(settings.mode);
+    }
+    
+    // the outgoing engine renders its own copy of the input until its fade is over
+    if (crossfadeRemaining > 0) {
+        crossfadeBuffer.setSize(buffer.getNumChannels(), bufferLength, false, false, true);
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+            crossfadeBuffer.copyFrom(channel, 0, buffer, channel, 0, bufferLength);
+        }
+        processMode(outgoingMode, crossfadeBuffer);
+    }
+    
+    processMode(activeMode, buffer);
+    
+    if (crossfadeRemaining > 0) {
+        crossfadeModes(buffer, bufferLength);
     }
+}
+
+void CompSoundFinalProjectAudioProcessor::processMode(const int mode, juce::AudioBuffer<float>& buffer) {
+    if (mode == 0) {
+        processBasicReverb(buffer);
+    } else {
+        processMyReverb(buffer);
+    }
+}
 
+void CompSoundFinalProjectAudioProcessor::processBasicReverb(juce::AudioBuffer<float>& buffer) {
+    auto audioBlock = juce::dsp::AudioBlock<float>(buffer);
+    auto processContext = juce::dsp::ProcessContextReplacing<float>(audioBlock);
+    reverb.setParameters(reverbParams);
+    reverb.setEnabled(true);
+    reverb.process(processContext);
+}
+
+void CompSoundFinalProjectAudioProcessor::processMyReverb(juce::AudioBuffer<float>& buffer) {
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    
+    const int bufferLength = buffer.getNumSamples();
+    const int delayBufferLength = multiChannelDelayBuffer.getNumSamples();
+    
     // convert the buffer buffer to multichannel
     for (int channel = 0; channel < MULTICHANNEL_TOTAL_INPUTS; ++channel) {
         int originalChannel = channel % totalNumInputChannels;
@@ -258,30 +264,23 @@ void CompSoundFinalProjectAudioProcessor::processBlock (juce::AudioBuffer<float>
     
     // diffuse the signal
     for (int i = 1; i <= (int)settings.diffusion; ++i) {
-        const int delay = static_cast<int>((20 + i) * pow(1.6, i));
-        diffuseBuffer(diffusedBufferHelperDataArr, delayBufferDataArr, bufferLength, delayBufferLength, delay);
+        diffuseBuffer(diffusedBufferHelperDataArr, delayBufferDataArr, bufferLength, delayBufferLength, topology.diffusionReadOffsets[i - 1]);
         
         const float diffuseGain = 0.9 - (i * 0.1); // decrease with each diffusion step
         
         // add diffuse helper buffer into main diffused buffer
         for (int channel = 0; channel < MULTICHANNEL_TOTAL_INPUTS; ++channel) {
-            const float* diffusedBufferHelperData = multiChannelDiffusedBufferHelper.getReadPointer(channel);
-            multiChannelDiffusedBuffer.addFromWithRamp(channel, 0, diffusedBufferHelperData, bufferLength, diffuseGain, diffuseGain);
+            kernels.addWithGain(diffusedBufferDataArr[channel], diffusedBufferHelperDataArr[channel], bufferLength, diffuseGain);
         }
     }
     
     // apply low pass to diffused signal
     // mix low passed diffused signal w/ regular diffused signal according to settings
-    for (int channel = 0; channel < MULTICHANNEL_TOTAL_INPUTS; ++channel) {
-        multiChannelDiffusedBufferLowPass.copyFrom(channel, 0, diffusedBufferDataArr[channel], bufferLength);
-        float* lowPassBufferData = multiChannelDiffusedBufferLowPass.getWritePointer(channel);
-        
-        lowPassFilters[channel].setCoefficients(juce::IIRCoefficients::makeLowPass(mSampleRate, settings.dampingFreq));
-        lowPassFilters[channel].processSamples(lowPassBufferData, bufferLength);
-        
-        multiChannelDiffusedBuffer.applyGain(channel, 0, bufferLength, 1 - settings.damping);
-        multiChannelDiffusedBuffer.addFromWithRamp(channel, 0, lowPassBufferData, bufferLength, settings.damping, settings.damping);
+    if (! juce::approximatelyEqual(settings.dampingFreq, dampingCoefficientsFreq)) {
+        dampingCoefficients = juce::IIRCoefficients::makeLowPass(mSampleRate, settings.dampingFreq);
+        dampingCoefficientsFreq = settings.dampingFreq;
     }
+    kernels.dampingFilter(diffusedBufferDataArr, bufferLength, dampingCoefficients.coefficients, dampingState, settings.damping);
     
     // fill the multichannel diffused circular delay buffer
     for (int channel = 0; channel < MULTICHANNEL_TOTAL_INPUTS; ++channel) {
@@ -290,16 +289,29 @@ void CompSoundFinalProjectAudioProcessor::processBlock (juce::AudioBuffer<float>
     }
  
     // add the feedback delay
-    int delay = settings.delayLength;
-    const int readPosition = getReadPosition(writePosition, delay, 0, delayBufferLength);
-    for (int i = 0; i < bufferLength; ++i) {
-        int bufferIndex = i;
-       
-        const int readPosition_ = (readPosition + bufferIndex) % delayBufferLength;
-        addFromDelayBuffer(bufferDataArr, diffusedDelayBufferDataArr, readPosition_, bufferIndex, settings.delayLength);
-        
+    // every line has its own loop length, worked in runs that neither wrap the circular
+    // buffer nor read anything written earlier in the same run, so the result matches
+    // going sample by sample
+    if (! juce::approximatelyEqual(settings.delayLength, feedbackLengthsDelay)) {
+        topology.getFeedbackLengths(settings.delayLength, feedbackLengths);
+        feedbackLengthsDelay = settings.delayLength;
+    }
+    const int shortestLength = *std::min_element(std::begin(feedbackLengths), std::end(feedbackLengths));
+    for (int i = 0; i < bufferLength;) {
         const int writePosition_ = (writePosition + i) % delayBufferLength;
-        feedbackDelay(bufferDataArr, diffusedDelayBufferDataArr, writePosition_, bufferIndex);
+        int runLength = juce::jmin(bufferLength - i, delayBufferLength - writePosition_, shortestLength);
+        
+        const float* delayedDataArr[MULTICHANNEL_TOTAL_INPUTS];
+        for (int channel = 0; channel < MULTICHANNEL_TOTAL_INPUTS; ++channel) {
+            const int readPosition_ = (writePosition_ + delayBufferLength - feedbackLengths[channel]) % delayBufferLength;
+            runLength = juce::jmin(runLength, delayBufferLength - readPosition_);
+            delayedDataArr[channel] = diffusedDelayBufferDataArr[channel] + readPosition_;
+        }
+        
+        addFromDelayBuffer(bufferDataArr, delayedDataArr, i, runLength);
+        feedbackDelay(bufferDataArr, diffusedDelayBufferDataArr, writePosition_, i, runLength);
+        
+        i += runLength;
     }
     
     // apply dry and wet gain individually
@@ -325,6 +337,64 @@ void CompSoundFinalProjectAudioProcessor::processBlock (juce::AudioBuffer<float>
     buffer.applyGain(settings.gain);
 }
 
+void CompSoundFinalProjectAudioProcessor::switchMode(const int mode) {
+    if (outgoingMode == mode) {
+        // switching back mid-fade: continue from the mirrored point so both gains stay continuous
+        crossfadeRemaining = static_cast<int>(crossfadeGains.size()) - 1 - crossfadeRemaining;
+    } else {
+        // the engine being faded out (if any) is cut short, the new one starts clean
+        if (outgoingMode >= 0) {
+            resetMode(outgoingMode);
+        }
+        crossfadeRemaining = static_cast<int>(crossfadeGains.size()) - 1;
+    }
+    
+    outgoingMode = activeMode;
+    activeMode = mode;
+    
+    // switched back before the fade got anywhere, nothing left to fade out
+    if (crossfadeRemaining == 0) {
+        resetMode(outgoingMode);
+        outgoingMode = -1;
+    }
+}
+
+void CompSoundFinalProjectAudioProcessor::crossfadeModes(juce::AudioBuffer<float>& buffer, const int bufferLength) {
+    const int crossfadeLength = static_cast<int>(crossfadeGains.size()) - 1;
+    const int fadePosition = crossfadeLength - crossfadeRemaining;
+    const int fadeSamples = juce::jmin(bufferLength, crossfadeRemaining);
+    
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        float* bufferData = buffer.getWritePointer(channel);
+        const float* outgoingData = crossfadeBuffer.getReadPointer(channel);
+        
+        for (int i = 0; i < fadeSamples; ++i) {
+            const auto position = static_cast<size_t>(fadePosition + i);
+            bufferData[i] = bufferData[i] * crossfadeGains[position]
+                          + outgoingData[i] * crossfadeGains[static_cast<size_t>(crossfadeLength) - position];
+        }
+    }
+    
+    crossfadeRemaining -= fadeSamples;
+    
+    // the outgoing engine is silent now, idle it and drop its tail
+    if (crossfadeRemaining == 0) {
+        resetMode(outgoingMode);
+        outgoingMode = -1;
+    }
+}
+
+void CompSoundFinalProjectAudioProcessor::resetMode(const int mode) {
+    if (mode == 0) {
+        reverb.reset();
+    } else {
+        multiChannelDelayBuffer.clear();
+        multiChannelDiffusedDelayBuffer.clear();
+        std::fill(std::begin(dampingState), std::end(dampingState), 0.0f);
+        writePosition = 0;
+    }
+}
+
 void CompSoundFinalProjectAudioProcessor::setReverbParameters() {
     reverbParams.roomSize = settings.roomSize;
     reverbParams.damping = settings.damping;
@@ -340,26 +410,8 @@ void CompSoundFinalProjectAudioProcessor::setReverbParameters() {
     reverb.setParameters(reverbParams);
 }
 
-int CompSoundFinalProjectAudioProcessor::getReadPosition(const int writePosition, const int delay, const int offset, const int delayBufferLength) {
-    int readPosition = static_cast<int>((writePosition + (delayBufferLength - (mSampleRate * delay / 1000)) + offset) % delayBufferLength);
-    return readPosition;
-}
-
-void CompSoundFinalProjectAudioProcessor::copyToMatrix(juce::dsp::Matrix<float>& matrix, float** buffer, const int bufferPos) {
-    for (int i = 0; i < MATRIX_SIZE; ++i) {
-        for (int j = 0; j < MATRIX_SIZE; ++j) {
-            matrix(i,j) = buffer[j][bufferPos];
-        }
-    }
-}
-
-void CompSoundFinalProjectAudioProcessor::copyFromMatrix(juce::dsp::Matrix<float>& matrix, float** buffer, const int bufferPos) {
-    for (int i = 0; i < MATRIX_SIZE; ++i) {
-        for (int j = 0; j < MATRIX_SIZE; ++j) {
-            buffer[j][bufferPos] =  matrix(i,j);
-        }
-    }
-
+void CompSoundFinalProjectAudioProcessor::setTopologySeed(const juce::int64 seed) {
+    topologySeed = seed;
 }
 
 void CompSoundFinalProjectAudioProcessor::fillDelayBuffer(
@@ -370,11 +422,11 @@ void CompSoundFinalProjectAudioProcessor::fillDelayBuffer(
                                                           const float* bufferData
                                                           ) {
     if (delayBufferLength > bufferLength + writePosition) {
-        delayBuffer.copyFromWithRamp(channel, writePosition, bufferData, bufferLength, 0.8, 0.8);
+        kernels.copyWithGain(delayBuffer.getWritePointer(channel, writePosition), bufferData, bufferLength, 0.8f);
     } else {
         int bufferRemaining = delayBufferLength - writePosition;
-        delayBuffer.copyFromWithRamp(channel, writePosition, bufferData, bufferRemaining, 0.8, 0.8);
-        delayBuffer.copyFromWithRamp(channel, 0, bufferData + bufferRemaining, bufferLength - bufferRemaining, 0.8, 0.8);
+        kernels.copyWithGain(delayBuffer.getWritePointer(channel, writePosition), bufferData, bufferRemaining, 0.8f);
+        kernels.copyWithGain(delayBuffer.getWritePointer(channel), bufferData + bufferRemaining, bufferLength - bufferRemaining, 0.8f);
     }
 }
 
@@ -383,76 +435,49 @@ void CompSoundFinalProjectAudioProcessor::diffuseBuffer(
                                                         float** delayBufferDataArr,
                                                         const int bufferLength,
                                                         const int delayBufferLength,
-                                                        const float delay
+                                                        const int* readOffsets
                                                         ) {
-    // use to break delay into evenly divided sections
-    const float delaySegment = delay / MULTICHANNEL_TOTAL_INPUTS;
-    
-    // add in evenly-distributed random delay to each channel
-    // diffuse step range = [0, delay)
-    // each channel has a segment of this range
-    // _____________________
-    // |    |    |    |    | <- a channel's delay falls somewhere in its segment
-    // |____|____|____|____|
-    //  seg0 seg1 seg2 seg3
-    //  delay increase-->
+    // read offsets come from the topology (see ReverbTopology::prepare)
     for (int i = 0; i < MULTICHANNEL_TOTAL_INPUTS; ++i) {
-        const int segment = delaySegment * i;
         // using fixed random delays
         // had tried using rand() here but got clicks :(
-        const int randomDelay = segment + diffuseDelays[i];
-        const int readPosition = getReadPosition(writePosition, randomDelay, 0, delayBufferLength);
-        for (int j = 0; j < bufferLength; ++j) {
-            const int readPosition_ = (readPosition + j) % delayBufferLength;
-            diffusedBufferDataArr[i][j] = delayBufferDataArr[i][readPosition_];
-        }
+        const int readPosition = (writePosition + delayBufferLength - readOffsets[i]) % delayBufferLength;
+        const int firstPart = juce::jmin(bufferLength, delayBufferLength - readPosition);
+        kernels.copyWithGain(diffusedBufferDataArr[i], delayBufferDataArr[i] + readPosition, firstPart, 1.0f);
+        kernels.copyWithGain(diffusedBufferDataArr[i] + firstPart, delayBufferDataArr[i], bufferLength - firstPart, 1.0f);
     }
    
-    // mix with permutation matrix
-    for (int i = 0; i < bufferLength; ++i) {
-        copyToMatrix(currentStepMatrix, diffusedBufferDataArr, i);
-        currentStepMatrixOutput = currentStepMatrix * permutationMatrix;
-        copyFromMatrix(currentStepMatrixOutput, diffusedBufferDataArr, i);
-    }
-    
-    // mix with hadamard matrix
-    for (int i = 0; i < bufferLength; ++i) {
-        copyToMatrix(currentStepMatrix, diffusedBufferDataArr, i);
-        currentStepMatrixOutput = currentStepMatrix * hadamardMatrix;
-        copyFromMatrix(currentStepMatrixOutput, diffusedBufferDataArr, i);
-    }
+    // mix with permutation matrix, then hadamard matrix
+    kernels.mixMatrix(diffusedBufferDataArr, 0, diffusedBufferDataArr, 0, bufferLength, topology.diffusionMatrix.getRawDataPointer(), 1.0f);
 
 };
 
 void CompSoundFinalProjectAudioProcessor::addFromDelayBuffer(
                                                              float** bufferDataArr,
-                                                             float** delayBufferDataArr,
-                                                             const int readPosition,
+                                                             const float* const* delayedDataArr,
                                                              const int bufferIndex,
-                                                             const int delay
+                                                             const int numSamples
                                                              ) {
    
-    copyToMatrix(currentStepMatrix, delayBufferDataArr, readPosition);
-    currentStepMatrixOutput = currentStepMatrix * householderMatrix;
-    currentStepMatrixOutput *= 0.8;
-    copyFromMatrix(currentStepMatrixOutput, bufferDataArr, bufferIndex);
+    kernels.mixMatrix(delayedDataArr, 0, bufferDataArr, bufferIndex, numSamples, topology.householderMatrix.getRawDataPointer(), 0.8f);
 }
 
 void CompSoundFinalProjectAudioProcessor::feedbackDelay(
                                                         float** bufferDataArr,
                                                         float** delayBufferDataArr,
                                                         const int writePosition,
-                                                        const int bufferIndex
+                                                        const int bufferIndex,
+                                                        const int numSamples
                                                         ) {
-    int decay;
+    float decay;
     if (settings.freezeMode) {
-        decay = 1.0;
+        decay = 1.0f;
     } else {
         decay = settings.decay;
     }
     
     for (int i = 0; i < MULTICHANNEL_TOTAL_INPUTS; ++i) {
-        delayBufferDataArr[i][writePosition] += (bufferDataArr[i][bufferIndex] * decay);
+        kernels.addWithGain(delayBufferDataArr[i] + writePosition, bufferDataArr[i] + bufferIndex, numSamples, decay);
     }
 }
 
@@ -503,6 +528,16 @@ Settings getSettings(juce::AudioProcessorValueTreeState& apvts) {
     return settings;
 }
 
+bool setSettingValue(juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID, float value) {
+    auto* parameter = apvts.getParameter(parameterID);
+    if (parameter == nullptr) {
+        return false;
+    }
+    
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    return true;
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout CompSoundFinalProjectAudioProcessor::createParameterLayout() {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
     
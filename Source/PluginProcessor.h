@@ -9,6 +9,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DSPKernels.h"
+#include "ReverbTopology.h"
 
 struct Settings {
     int mode { 0 };
@@ -28,6 +30,8 @@ struct Settings {
 };
 
 Settings getSettings(juce::AudioProcessorValueTreeState& apvts);
+// sets a parameter by its ID in real units (ms, Hz, mode index...), false if there is no such parameter
+bool setSettingValue(juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID, float value);
 
 const std::string MODE = "Mode";
 const std::string GAIN = "Gain";
@@ -46,6 +50,11 @@ const std::string REVERSE = "Reverse";
 
 const int MULTICHANNEL_TOTAL_INPUTS = 4;
 const int MATRIX_SIZE = 4;
+static_assert(MULTICHANNEL_TOTAL_INPUTS == KERNEL_CHANNELS && MATRIX_SIZE == KERNEL_CHANNELS,
+              "the DSP kernels are written for a fixed number of lines");
+
+// length of the equal-power crossfade when switching modes
+const float MODE_CROSSFADE_SECONDS = 0.05f;
 
 const juce::String modes[] {
     "Basic Reverb",
@@ -71,14 +80,19 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processMode(const int mode, juce::AudioBuffer<float>& buffer);
+    void processBasicReverb(juce::AudioBuffer<float>& buffer);
+    void processMyReverb(juce::AudioBuffer<float>& buffer);
+    void switchMode(const int mode);
+    void crossfadeModes(juce::AudioBuffer<float>& buffer, const int bufferLength);
+    void resetMode(const int mode);
     void setReverbParameters();
-    void copyToMatrix(juce::dsp::Matrix<float>& matrix, float** buffer, const int bufferPos);
-    void copyFromMatrix(juce::dsp::Matrix<float>& matrix, float** buffer, const int bufferPos);
-    int getReadPosition(const int writePosition, const int delay, const int offset, const int delayBufferLength);
+    // seed for the delay network of "My Reverb", used from the next prepareToPlay
+    void setTopologySeed(const juce::int64 seed);
     void fillDelayBuffer(juce::AudioBuffer<float>& delayBuffer, int channel, const int bufferLength, const int delayBufferLength, const float* bufferData);
-    void diffuseBuffer(float** diffusedBufferDataArr, float** delayBufferDataArr, const int bufferLength, const int delayBufferLength, const float delay);
-    void addFromDelayBuffer(float** bufferDataArr, float** delayBufferDataArr, const int readPosition, const int bufferIndex, const int delay);
-    void feedbackDelay(float** bufferDataArr, float** delayBufferDataArr, const int writePosition, const int bufferIndex);
+    void diffuseBuffer(float** diffusedBufferDataArr, float** delayBufferDataArr, const int bufferLength, const int delayBufferLength, const int* readOffsets);
+    void addFromDelayBuffer(float** bufferDataArr, const float* const* delayedDataArr, const int bufferIndex, const int numSamples);
+    void feedbackDelay(float** bufferDataArr, float** delayBufferDataArr, const int writePosition, const int bufferIndex, const int numSamples);
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -110,32 +124,39 @@ private:
     juce::AudioBuffer<float> multiChannelBuffer;
     juce::AudioBuffer<float> multiChannelDiffusedBuffer;
     juce::AudioBuffer<float> multiChannelDiffusedBufferHelper;
-    juce::AudioBuffer<float> multiChannelDiffusedBufferLowPass;
     juce::AudioBuffer<float> multiChannelDelayBuffer;
     juce::AudioBuffer<float> multiChannelDiffusedDelayBuffer;
-    std::vector<int> diffuseDelays {MULTICHANNEL_TOTAL_INPUTS};
     int writePosition { 0 };
     int mSampleRate;
     
     // dsp effects variables
-        enum {
-        reverbIndex
-    };
-    juce::dsp::ProcessorChain<juce::dsp::Reverb> processorChain;
     juce::dsp::Reverb reverb;
     juce::dsp::Reverb::Parameters reverbParams;
     Settings settings;
     
-    // diffuser variables
-    juce::dsp::Matrix<float> householderMatrix { juce::dsp::Matrix<float>(MATRIX_SIZE, MATRIX_SIZE) };
-    juce::dsp::Matrix<float> hadamardMatrix { juce::dsp::Matrix<float>(MATRIX_SIZE, MATRIX_SIZE) };
-    juce::dsp::Matrix<float> permutationMatrix { juce::dsp::Matrix<float>(MATRIX_SIZE, MATRIX_SIZE) };
-    juce::dsp::Matrix<float> currentStepMatrix { juce::dsp::Matrix<float>(MATRIX_SIZE, MATRIX_SIZE) };
-    juce::dsp::Matrix<float> currentStepMatrixOutput { juce::dsp::Matrix<float>(MATRIX_SIZE, MATRIX_SIZE) };
+    // mode switching variables
+    // only activeMode is processed, except while outgoingMode fades out
+    int activeMode { 0 };
+    int outgoingMode { -1 };
+    int crossfadeRemaining { 0 };
+    juce::AudioBuffer<float> crossfadeBuffer;
+    std::vector<float> crossfadeGains;
     
+    // diffuser variables (matrices and delays)
+    ReverbTopology topology;
+    juce::int64 topologySeed { DEFAULT_TOPOLOGY_SEED };
+    // feedback loop length of every line, for the pre-delay in feedbackLengthsDelay
+    int feedbackLengths[MULTICHANNEL_TOTAL_INPUTS] {};
+    float feedbackLengthsDelay { 0 };
     
     // reverb effect variables
-    juce::IIRFilter lowPassFilters[MULTICHANNEL_TOTAL_INPUTS];
+    // lowpass state for every line, v1 then v2 (see DSPKernels::dampingFilter)
+    juce::IIRCoefficients dampingCoefficients;
+    float dampingCoefficientsFreq { 0 };
+    float dampingState[2 * MULTICHANNEL_TOTAL_INPUTS] {};
+    
+    // SIMD kernels for the CPU we are running on
+    const DSPKernels& kernels { getDSPKernels() };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CompSoundFinalProjectAudioProcessor)
 };
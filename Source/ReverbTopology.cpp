@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    ReverbTopology.cpp
+
+  ==============================================================================
+*/
+
+#include "ReverbTopology.h"
+
+namespace {
+
+// every diffusion step reads each line up to this much later than the start of its segment
+const double DIFFUSION_JITTER_MS = 20.0;
+// feedback spreads fall between FEEDBACK_SPREAD_MS and 5 * FEEDBACK_SPREAD_MS
+const double FEEDBACK_SPREAD_MS = 1.0;
+
+bool isPrime(int n) {
+    if (n < 2) {
+        return false;
+    }
+    for (int divisor = 2; divisor * divisor <= n; ++divisor) {
+        if (n % divisor == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// first prime >= n that is not one of the numUsed primes in used
+int nextUnusedPrime(int n, const int* used, int numUsed) {
+    for (;; ++n) {
+        if (isPrime(n) && std::find(used, used + numUsed, n) == used + numUsed) {
+            return n;
+        }
+    }
+}
+
+}
+
+void ReverbTopology::prepare(double newSampleRate, juce::int64 seed) {
+    sampleRate = newSampleRate;
+
+    // setting householder matrix
+    for (int i = 0; i < KERNEL_CHANNELS; i++) {
+        for (int j = 0; j < KERNEL_CHANNELS; j++) {
+            if (i == j) {
+                householderMatrix(i, j) = 0.5;
+            } else {
+                householderMatrix(i, j) = -0.5;
+            }
+        }
+    }
+
+    // (tediously) setting hadamard matrix
+    for (int i = 0; i < KERNEL_CHANNELS; i++) {
+        for (int j = 0; j < KERNEL_CHANNELS; j++) {
+            if (i == 0 || j == 0 || (i == 3 && j == 3)
+                || (i == 1 && j == 2) || (i == 2 && j == 1)) {
+                hadamardMatrix(i, j) = 1;
+            } else {
+                hadamardMatrix(i, j) = -1;
+            }
+        }
+    }
+
+    // setting permutation matrix
+    for (int i = 0; i < KERNEL_CHANNELS; i++) {
+        for (int j = 0; j < KERNEL_CHANNELS; j++) {
+            permutationMatrix(i, j) = 0;
+        }
+    }
+    // statically setting for now
+    permutationMatrix(0,3) = 1;
+    permutationMatrix(1,2) = -1;
+    permutationMatrix(2,0) = 1;
+    permutationMatrix(3,1) = -1;
+
+    diffusionMatrix = permutationMatrix * hadamardMatrix;
+
+    juce::Random random(seed);
+    int usedDelays[MAX_DIFFUSION_STEPS * KERNEL_CHANNELS + KERNEL_CHANNELS];
+    int numUsedDelays = 0;
+
+    // add in evenly-distributed random delay to each channel
+    // diffuse step range = [0, delay)
+    // each channel has a segment of this range
+    // _____________________
+    // |    |    |    |    | <- a channel's delay falls somewhere in its segment
+    // |____|____|____|____|
+    //  seg0 seg1 seg2 seg3
+    //  delay increase-->
+    const double jitterSamples = sampleRate * DIFFUSION_JITTER_MS / 1000.0;
+    for (int step = 0; step < MAX_DIFFUSION_STEPS; ++step) {
+        const int i = step + 1;
+        const double delaySamples = sampleRate * (20 + i) * std::pow(1.6, i) / 1000.0;
+        const double delaySegment = delaySamples / KERNEL_CHANNELS;
+
+        for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+            const int randomDelay = juce::roundToInt(delaySegment * line + random.nextDouble() * jitterSamples);
+            diffusionReadOffsets[step][line] = nextUnusedPrime(randomDelay, usedDelays, numUsedDelays);
+            usedDelays[numUsedDelays++] = diffusionReadOffsets[step][line];
+        }
+    }
+
+    // line n gets a spread between n + 1 and n + 2 ms
+    const double spreadSamples = sampleRate * FEEDBACK_SPREAD_MS / 1000.0;
+    for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+        const int spread = juce::roundToInt((1 + line + random.nextDouble()) * spreadSamples);
+        feedbackSpreads[line] = nextUnusedPrime(spread, usedDelays, numUsedDelays);
+        usedDelays[numUsedDelays++] = feedbackSpreads[line];
+    }
+}
+
+void ReverbTopology::getFeedbackLengths(float preDelayMs, int* lengths) const {
+    // the diffusion offsets are taken, the lengths picked so far are added after them
+    const int numDiffusionDelays = MAX_DIFFUSION_STEPS * KERNEL_CHANNELS;
+    int usedDelays[MAX_DIFFUSION_STEPS * KERNEL_CHANNELS + KERNEL_CHANNELS];
+    std::copy(&diffusionReadOffsets[0][0], &diffusionReadOffsets[0][0] + numDiffusionDelays, usedDelays);
+
+    const int preDelay = juce::roundToInt(preDelayMs * sampleRate / 1000.0);
+    for (int line = 0; line < KERNEL_CHANNELS; ++line) {
+        lengths[line] = nextUnusedPrime(preDelay + feedbackSpreads[line], usedDelays, numDiffusionDelays + line);
+        usedDelays[numDiffusionDelays + line] = lengths[line];
+    }
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    ReverbTopology.h
+
+    The parts of the "My Reverb" network that do not change with the
+    parameters: the mixing matrices and every delay in samples. Built once
+    in prepare() and shared by everything that runs the network, so the
+    processor and every lane of a BatchedReverb index the same tables.
+
+    The delays come from a seeded generator, so the same seed and sample
+    rate always give the same network (and the same render). They are
+    distinct primes, which keeps them mutually prime and stops echoes of
+    different lines from piling up on the same samples.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSPKernels.h"
+
+// upper end of the Diffusion parameter
+const int MAX_DIFFUSION_STEPS = 8;
+
+const juce::int64 DEFAULT_TOPOLOGY_SEED = 1;
+
+struct ReverbTopology {
+    void prepare(double sampleRate, juce::int64 seed);
+
+    // length of every line's feedback loop for a pre-delay: the pre-delay plus the
+    // line's spread, moved up to primes distinct from each other and from the
+    // diffusion offsets. Cheap, but not for every block, callers keep the result
+    // until the pre-delay changes
+    void getFeedbackLengths(float preDelayMs, int* lengths) const;
+
+    juce::dsp::Matrix<float> householderMatrix { juce::dsp::Matrix<float>(KERNEL_CHANNELS, KERNEL_CHANNELS) };
+    juce::dsp::Matrix<float> hadamardMatrix { juce::dsp::Matrix<float>(KERNEL_CHANNELS, KERNEL_CHANNELS) };
+    juce::dsp::Matrix<float> permutationMatrix { juce::dsp::Matrix<float>(KERNEL_CHANNELS, KERNEL_CHANNELS) };
+    // permutation then hadamard, applied in one pass per diffusion step
+    juce::dsp::Matrix<float> diffusionMatrix { juce::dsp::Matrix<float>(KERNEL_CHANNELS, KERNEL_CHANNELS) };
+
+    double sampleRate { 44100 };
+
+    // how far behind the write head each line reads in diffusion step (step + 1), in samples
+    int diffusionReadOffsets[MAX_DIFFUSION_STEPS][KERNEL_CHANNELS] {};
+    // added to the pre-delay to give every line its own feedback loop length, in samples
+    int feedbackSpreads[KERNEL_CHANNELS] {};
+};
@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    StreamingRenderer.cpp
+
+  ==============================================================================
+*/
+
+#include "StreamingRenderer.h"
+
+StreamingRenderer::StreamingRenderer(juce::AudioProcessor& p, const RenderOptions& o)
+    : processor(p), options(o)
+{
+    formatManager.registerBasicFormats();
+}
+
+juce::Result StreamingRenderer::render(const juce::File& inputFile, const juce::File& outputFile, RenderStats& stats) {
+    const auto renderStart = juce::Time::getHighResolutionTicks();
+    aborted = false;
+    writeFailed = false;
+
+    std::unique_ptr<juce::AudioFormatReader> reader = openInput(inputFile, stats.memoryMappedInput);
+    if (reader == nullptr) {
+        return juce::Result::fail("Could not read " + inputFile.getFullPathName());
+    }
+
+    // the reader maps mono and stereo onto each other, but anything wider has to
+    // match channel for channel or the missing channels are silently zero-filled
+    const int numInputChannels = processor.getTotalNumInputChannels();
+    const int numFileChannels = static_cast<int>(reader->numChannels);
+    if (numFileChannels != numInputChannels && (numFileChannels > 2 || numInputChannels > 2)) {
+        return juce::Result::fail(inputFile.getFileName() + " has " + juce::String(numFileChannels)
+                                  + " channels, the processor takes " + juce::String(numInputChannels));
+    }
+
+    auto* outputFormat = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+    if (outputFormat == nullptr) {
+        return juce::Result::fail("No audio format for " + outputFile.getFileName());
+    }
+
+    const int numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+    const int numOutputChannels = processor.getTotalNumOutputChannels();
+
+    outputFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+    if (stream == nullptr) {
+        return juce::Result::fail("Could not write " + outputFile.getFullPathName());
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(outputFormat->createWriterFor(stream.get(),
+                                                                                  reader->sampleRate,
+                                                                                  static_cast<unsigned int>(numOutputChannels),
+                                                                                  options.bitsPerSample,
+                                                                                  {},
+                                                                                  0));
+    if (writer == nullptr) {
+        return juce::Result::fail("Could not create a " + outputFormat->getFormatName() + " writer");
+    }
+    // the writer owns the stream now
+    stream.release();
+
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(reader->sampleRate, options.blockSize);
+    processor.prepareToPlay(reader->sampleRate, options.blockSize);
+
+    stats.sampleRate = reader->sampleRate;
+    const juce::int64 totalSamples = reader->lengthInSamples + static_cast<juce::int64>(options.tailSeconds * reader->sampleRate);
+
+    AudioBlockFifo inputFifo(numChannels, options.blockSize, options.fifoBlocks);
+    AudioBlockFifo outputFifo(numChannels, options.blockSize, options.fifoBlocks);
+
+    std::thread decodeThread([&] { decode(*reader, inputFifo, totalSamples); });
+    std::thread encodeThread([&] { encode(*writer, outputFifo); });
+
+    process(inputFifo, outputFifo, numChannels, stats);
+
+    decodeThread.join();
+    encodeThread.join();
+
+    processor.releaseResources();
+
+    // flushes and closes the file
+    writer.reset();
+
+    stats.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - renderStart);
+
+    if (writeFailed) {
+        return juce::Result::fail("Writing " + outputFile.getFullPathName() + " failed");
+    }
+
+    return juce::Result::ok();
+}
+
+std::unique_ptr<juce::AudioFormatReader> StreamingRenderer::openInput(const juce::File& inputFile, bool& memoryMapped) {
+    // uncompressed files are mapped straight into memory, the decode
+    // thread then only converts samples and takes the page faults
+    if (auto* format = formatManager.findFormatForFileExtension(inputFile.getFileExtension())) {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader(format->createMemoryMappedReader(inputFile));
+        if (mappedReader != nullptr && mappedReader->mapEntireFile()) {
+            memoryMapped = true;
+            return mappedReader;
+        }
+    }
+
+    memoryMapped = false;
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(inputFile));
+}
+
+void StreamingRenderer::decode(juce::AudioFormatReader& reader, AudioBlockFifo& inputFifo, const juce::int64 totalSamples) {
+    double secondsWaited = 0;
+
+    for (juce::int64 position = 0; position < totalSamples;) {
+        auto* block = inputFifo.waitForWriteBlock(aborted, secondsWaited);
+        if (block == nullptr) {
+            break;
+        }
+
+        const int numSamples = static_cast<int>(juce::jmin<juce::int64>(options.blockSize, totalSamples - position));
+        const int samplesFromFile = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, reader.lengthInSamples - position));
+
+        if (samplesFromFile > 0) {
+            reader.read(block, 0, samplesFromFile, position, true, true);
+        }
+        if (samplesFromFile < numSamples) {
+            block->clear(samplesFromFile, numSamples - samplesFromFile);
+        }
+
+        inputFifo.finishWrite(numSamples);
+        position += numSamples;
+    }
+
+    inputFifo.markFinished();
+}
+
+void StreamingRenderer::process(AudioBlockFifo& inputFifo, AudioBlockFifo& outputFifo, const int numChannels, RenderStats& stats) {
+    juce::MidiBuffer midiMessages;
+
+    for (;;) {
+        int numSamples = 0;
+        auto* inputBlock = inputFifo.waitForReadBlock(numSamples, aborted, stats.inputStallSeconds);
+        if (inputBlock == nullptr) {
+            break;
+        }
+
+        // view of exactly numSamples, processors size their work from the buffer
+        juce::AudioBuffer<float> buffer(inputBlock->getArrayOfWritePointers(), numChannels, numSamples);
+
+        const auto processStart = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midiMessages);
+        stats.dspSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - processStart);
+        midiMessages.clear();
+
+        auto* outputBlock = outputFifo.waitForWriteBlock(aborted, stats.outputStallSeconds);
+        if (outputBlock == nullptr) {
+            break;
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            outputBlock->copyFrom(channel, 0, buffer, channel, 0, numSamples);
+        }
+
+        inputFifo.finishRead();
+        outputFifo.finishWrite(numSamples);
+        stats.samplesRendered += numSamples;
+    }
+
+    outputFifo.markFinished();
+}
+
+void StreamingRenderer::encode(juce::AudioFormatWriter& writer, AudioBlockFifo& outputFifo) {
+    double secondsWaited = 0;
+
+    for (;;) {
+        int numSamples = 0;
+        auto* block = outputFifo.waitForReadBlock(numSamples, aborted, secondsWaited);
+        if (block == nullptr) {
+            break;
+        }
+
+        if (! writer.writeFromAudioSampleBuffer(*block, 0, numSamples)) {
+            // stop the other stages, nothing more can be written
+            writeFailed = true;
+            aborted = true;
+            break;
+        }
+
+        outputFifo.finishRead();
+    }
+}
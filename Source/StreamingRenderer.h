@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    StreamingRenderer.h
+
+    Offline file -> processor -> file rendering without a host.
+
+    Three threads run side by side, connected by bounded AudioBlockFifos:
+      decode  reads the input (memory-mapped when it is uncompressed) and
+              appends the reverb tail as silence
+      dsp     the calling thread, runs processBlock and nothing else
+      encode  writes the output file
+    so disk and codec time overlap the processing instead of adding to it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioBlockFifo.h"
+
+struct RenderOptions {
+    int blockSize { 512 };
+    // blocks buffered between each pair of stages
+    int fifoBlocks { 64 };
+    // silence appended after the input so the reverb can ring out
+    double tailSeconds { 2.0 };
+    int bitsPerSample { 24 };
+};
+
+struct RenderStats {
+    bool memoryMappedInput { false };
+    double sampleRate { 0 };
+    juce::int64 samplesRendered { 0 };
+    // time spent in processBlock
+    double dspSeconds { 0 };
+    // time the dsp thread waited for the decoder / for the encoder
+    double inputStallSeconds { 0 };
+    double outputStallSeconds { 0 };
+    double wallSeconds { 0 };
+};
+
+class StreamingRenderer
+{
+public:
+    StreamingRenderer(juce::AudioProcessor& processor, const RenderOptions& options);
+
+    // prepares the processor at the input's sample rate, renders, then releases it.
+    // Fails if the input's channel count doesn't match the processor's inputs
+    // (mono and stereo are interchangeable)
+    juce::Result render(const juce::File& inputFile, const juce::File& outputFile, RenderStats& stats);
+
+private:
+    std::unique_ptr<juce::AudioFormatReader> openInput(const juce::File& inputFile, bool& memoryMapped);
+    void decode(juce::AudioFormatReader& reader, AudioBlockFifo& inputFifo, const juce::int64 totalSamples);
+    void process(AudioBlockFifo& inputFifo, AudioBlockFifo& outputFifo, const int numChannels, RenderStats& stats);
+    void encode(juce::AudioFormatWriter& writer, AudioBlockFifo& outputFifo);
+
+    juce::AudioProcessor& processor;
+    RenderOptions options;
+    juce::AudioFormatManager formatManager;
+
+    std::atomic<bool> aborted { false };
+    std::atomic<bool> writeFailed { false };
+
+    JUCE_DECLARE_NON_COPYABLE (StreamingRenderer)
+};
@@ -0,0 +1,490 @@
+/*
+  ==============================================================================
+
+    Checks what every "My Reverb" render relies on, without audio files or a
+    plugin host. Prints each failure and exits with 1 if there was any, so
+    it runs under ctest as well as by hand.
+
+    CompSoundCheck [--bench]
+
+    - the same seed and sample rate give the same delay network, a
+      different seed a different one
+    - at 44.1, 48 and 96 kHz the diffusion offsets and the feedback lengths
+      are pairwise coprime for every Pre-Delay value
+    - every one of those delays fits in the delay buffers
+    - a BatchedReverb with 8 lanes of different settings renders every lane
+      bit for bit the same as a 1-lane BatchedReverb with that lane's settings
+    - a 1-lane BatchedReverb stays within MAX_ENGINE_DIFFERENCE of the
+      processor's "My Reverb", which it re-implements
+    - switching Mode during a render, including back again mid-fade, leaves
+      no step at the switch; My Reverb switched back to after its fade-out
+      matches a freshly prepared one, and switching back before the fade
+      got anywhere leaves it untouched
+
+    --bench also times BatchedReverb with 1, 4, 8 and 16 lanes and prints the
+    cost per stem, which is what batching stems is meant to bring down.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include "BatchedReverb.h"
+#include "PluginProcessor.h"
+#include "ReverbTopology.h"
+
+namespace {
+
+void printUsage() {
+    std::cout << "usage: CompSoundCheck [--bench]" << std::endl;
+}
+
+const double checkedSampleRates[] { 44100.0, 48000.0, 96000.0 };
+const juce::int64 checkedSeeds[] { DEFAULT_TOPOLOGY_SEED, 2, 3, 1234567 };
+
+// BatchedReverb adds up the same terms as the processor in a different order
+const float MAX_ENGINE_DIFFERENCE = 1e-5f;
+
+// how far past a mode switch to look for steps, in samples
+const int SWITCH_WINDOW = 64;
+
+int numFailures = 0;
+
+void fail(const juce::String& what) {
+    std::cerr << "FAIL: " << what << std::endl;
+    ++numFailures;
+}
+
+juce::String describe(double sampleRate, juce::int64 seed, float preDelayMs) {
+    return juce::String(sampleRate) + " Hz, seed " + juce::String(seed)
+        + ", pre-delay " + juce::String(preDelayMs) + " ms";
+}
+
+// every delay the network reads at a pre-delay: the diffusion offsets, then the feedback lengths
+std::vector<int> getDelays(const ReverbTopology& topology, float preDelayMs) {
+    const int* diffusionOffsets = &topology.diffusionReadOffsets[0][0];
+    std::vector<int> delays(diffusionOffsets, diffusionOffsets + MAX_DIFFUSION_STEPS * KERNEL_CHANNELS);
+
+    int feedbackLengths[KERNEL_CHANNELS];
+    topology.getFeedbackLengths(preDelayMs, feedbackLengths);
+    delays.insert(delays.end(), feedbackLengths, feedbackLengths + KERNEL_CHANNELS);
+    return delays;
+}
+
+void checkSeeds(const juce::NormalisableRange<float>& preDelayRange) {
+    const float preDelays[] { preDelayRange.start, 100.0f, preDelayRange.end };
+
+    for (const double sampleRate : checkedSampleRates) {
+        for (const juce::int64 seed : checkedSeeds) {
+            ReverbTopology first;
+            ReverbTopology second;
+            ReverbTopology other;
+            first.prepare(sampleRate, seed);
+            second.prepare(sampleRate, seed);
+            other.prepare(sampleRate, seed + 1);
+
+            for (const float preDelayMs : preDelays) {
+                if (getDelays(first, preDelayMs) != getDelays(second, preDelayMs)) {
+                    fail("same seed, different delays at " + describe(sampleRate, seed, preDelayMs));
+                }
+                if (getDelays(first, preDelayMs) == getDelays(other, preDelayMs)) {
+                    fail("seed " + juce::String(seed + 1) + " repeats the delays at " + describe(sampleRate, seed, preDelayMs));
+                }
+            }
+        }
+    }
+}
+
+void checkDelays(const juce::NormalisableRange<float>& preDelayRange) {
+    const int numPreDelays = juce::roundToInt((preDelayRange.end - preDelayRange.start) / preDelayRange.interval) + 1;
+
+    for (const double sampleRate : checkedSampleRates) {
+        // the delay buffers are sampleRate frames longer than a block, so the
+        // current block never overwrites anything less than a second old
+        const int longestDelay = static_cast<int>(sampleRate);
+
+        for (const juce::int64 seed : checkedSeeds) {
+            ReverbTopology topology;
+            topology.prepare(sampleRate, seed);
+
+            // stop at the first failure for each rate and seed, the pre-delays after it mostly repeat it
+            bool passed = true;
+            for (int i = 0; i < numPreDelays && passed; ++i) {
+                const float preDelayMs = preDelayRange.start + static_cast<float>(i) * preDelayRange.interval;
+                const std::vector<int> delays = getDelays(topology, preDelayMs);
+
+                for (size_t a = 0; a < delays.size() && passed; ++a) {
+                    if (delays[a] <= 0 || delays[a] > longestDelay) {
+                        fail("delay of " + juce::String(delays[a]) + " samples does not fit the delay buffer at "
+                             + describe(sampleRate, seed, preDelayMs));
+                        passed = false;
+                    }
+
+                    for (size_t b = a + 1; b < delays.size() && passed; ++b) {
+                        if (std::gcd(delays[a], delays[b]) != 1) {
+                            fail(juce::String(delays[a]) + " and " + juce::String(delays[b])
+                                 + " are not coprime at " + describe(sampleRate, seed, preDelayMs));
+                            passed = false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// numChannels of noise between -0.1 and 0.1, the same every run
+juce::AudioBuffer<float> makeNoise(int numChannels, int numSamples) {
+    juce::Random random(DEFAULT_TOPOLOGY_SEED);
+    juce::AudioBuffer<float> noise(numChannels, numSamples);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        float* data = noise.getWritePointer(channel);
+        for (int n = 0; n < numSamples; ++n) {
+            data[n] = (random.nextFloat() * 2 - 1) * 0.1f;
+        }
+    }
+    return noise;
+}
+
+// numChannels of a 220 Hz sine fading in over 100 ms, with no steps for the engines to pass on
+juce::AudioBuffer<float> makeSine(int numChannels, int numSamples, double sampleRate) {
+    const double fadeInSamples = sampleRate * 0.1;
+    juce::AudioBuffer<float> sine(numChannels, numSamples);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        float* data = sine.getWritePointer(channel);
+        for (int n = 0; n < numSamples; ++n) {
+            const double fadeIn = n < fadeInSamples ? 0.5 - 0.5 * std::cos(juce::MathConstants<double>::pi * n / fadeInSamples) : 1.0;
+            data[n] = static_cast<float>(0.5 * fadeIn * std::sin(2.0 * juce::MathConstants<double>::pi * 220.0 * n / sampleRate));
+        }
+    }
+    return sine;
+}
+
+// runs 2 * reverb.getNumLanes() channels of input, from firstChannel on, through reverb block by block
+juce::AudioBuffer<float> renderLanes(BatchedReverb& reverb, const juce::AudioBuffer<float>& input, int firstChannel, int blockSize) {
+    const int numChannels = 2 * reverb.getNumLanes();
+    const int numSamples = input.getNumSamples();
+    juce::AudioBuffer<float> output(numChannels, numSamples);
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+
+    for (int start = 0; start < numSamples; start += blockSize) {
+        const int numFrames = juce::jmin(blockSize, numSamples - start);
+        block.setSize(numChannels, numFrames, false, false, true);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            block.copyFrom(channel, 0, input, firstChannel + channel, start, numFrames);
+        }
+        reverb.process(block);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            output.copyFrom(channel, start, block, channel, 0, numFrames);
+        }
+    }
+    return output;
+}
+
+// a parameter ID and the value to set it to
+using ParameterValues = std::vector<std::pair<juce::String, float>>;
+
+void setParameters(CompSoundFinalProjectAudioProcessor& processor, const ParameterValues& values) {
+    for (const auto& value : values) {
+        setSettingValue(processor.apvts, value.first, value.second);
+    }
+}
+
+// Mode set to mode before block number block. inEmptyBlock also hands the processor
+// a block of 0 samples right away, so the switch starts there, as a host may do
+struct ModeChange {
+    int block;
+    int mode;
+    bool inEmptyBlock;
+};
+
+// runs input through processor block by block, changing nothing but Mode
+juce::AudioBuffer<float> renderProcessor(CompSoundFinalProjectAudioProcessor& processor, const juce::AudioBuffer<float>& input, int blockSize,
+                                         const std::vector<ModeChange>& modeChanges = {}) {
+    juce::AudioBuffer<float> output;
+    output.makeCopyOf(input);
+    juce::MidiBuffer midi;
+
+    juce::AudioBuffer<float> emptyBlock(input.getNumChannels(), 0);
+    juce::AudioBuffer<float> block(input.getNumChannels(), blockSize);
+    for (int start = 0; start < input.getNumSamples(); start += blockSize) {
+        for (const auto& change : modeChanges) {
+            if (change.block * blockSize == start) {
+                setSettingValue(processor.apvts, juce::String(MODE), static_cast<float>(change.mode));
+                if (change.inEmptyBlock) {
+                    processor.processBlock(emptyBlock, midi);
+                }
+            }
+        }
+
+        const int numSamples = juce::jmin(blockSize, input.getNumSamples() - start);
+        block.setSize(input.getNumChannels(), numSamples, false, false, true);
+        for (int channel = 0; channel < input.getNumChannels(); ++channel) {
+            block.copyFrom(channel, 0, input, channel, start, numSamples);
+        }
+        processor.processBlock(block, midi);
+        for (int channel = 0; channel < input.getNumChannels(); ++channel) {
+            output.copyFrom(channel, start, block, channel, 0, numSamples);
+        }
+    }
+    return output;
+}
+
+// largest absolute difference between a and b over numSamples from start
+float getMaxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b, int start, int numSamples) {
+    float maxDifference = 0;
+    for (int channel = 0; channel < a.getNumChannels(); ++channel) {
+        const float* aData = a.getReadPointer(channel);
+        const float* bData = b.getReadPointer(channel);
+        for (int n = start; n < start + numSamples; ++n) {
+            maxDifference = juce::jmax(maxDifference, std::abs(aData[n] - bData[n]));
+        }
+    }
+    return maxDifference;
+}
+
+// largest difference between neighbouring samples over numSamples from start
+float getMaxStep(const juce::AudioBuffer<float>& buffer, int start, int numSamples) {
+    float maxStep = 0;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        const float* data = buffer.getReadPointer(channel);
+        for (int n = juce::jmax(1, start); n < start + numSamples; ++n) {
+            maxStep = juce::jmax(maxStep, std::abs(data[n] - data[n - 1]));
+        }
+    }
+    return maxStep;
+}
+
+void checkModeSwitching() {
+    const double sampleRate = 48000;
+    const int blockSize = 256;
+    const int numSamples = 120 * blockSize;
+    const int crossfadeLength = static_cast<int>(sampleRate * MODE_CROSSFADE_SECONDS);
+    const juce::AudioBuffer<float> input = makeSine(2, numSamples, sampleRate);
+
+    // each engine on its own sets the size of a step that is just the signal
+    float maxSignalStep = 0;
+    for (const int mode : { 0, 1 }) {
+        CompSoundFinalProjectAudioProcessor processor;
+        setSettingValue(processor.apvts, juce::String(MODE), static_cast<float>(mode));
+        processor.prepareToPlay(sampleRate, blockSize);
+        const juce::AudioBuffer<float> output = renderProcessor(processor, input, blockSize);
+        maxSignalStep = juce::jmax(maxSignalStep, getMaxStep(output, 0, numSamples));
+    }
+
+    // to Basic Reverb, back to My Reverb mid-fade, to Basic Reverb until the fade
+    // is over, then back to a My Reverb that has been reset
+    const std::vector<ModeChange> modeChanges {
+        { 20, 0, false },
+        { 24, 1, false },
+        { 40, 0, false },
+        { 70, 1, false }
+    };
+    CompSoundFinalProjectAudioProcessor switched;
+    setSettingValue(switched.apvts, juce::String(MODE), 1.0f);
+    switched.prepareToPlay(sampleRate, blockSize);
+    const juce::AudioBuffer<float> switchedOutput = renderProcessor(switched, input, blockSize, modeChanges);
+
+    for (const auto& change : modeChanges) {
+        const float maxStep = getMaxStep(switchedOutput, change.block * blockSize, SWITCH_WINDOW);
+        if (maxStep > 2 * maxSignalStep) {
+            fail("switching to mode " + juce::String(change.mode) + " at block " + juce::String(change.block)
+                 + " steps by " + juce::String(maxStep) + ", the signal by at most " + juce::String(maxSignalStep));
+        }
+    }
+
+    // once the fade is over only the new engine is heard
+    const int lastSwitch = modeChanges.back().block * blockSize;
+    juce::AudioBuffer<float> laterInput(2, numSamples - lastSwitch);
+    for (int channel = 0; channel < 2; ++channel) {
+        laterInput.copyFrom(channel, 0, input, channel, lastSwitch, numSamples - lastSwitch);
+    }
+    CompSoundFinalProjectAudioProcessor fresh;
+    setSettingValue(fresh.apvts, juce::String(MODE), 1.0f);
+    fresh.prepareToPlay(sampleRate, blockSize);
+    const juce::AudioBuffer<float> freshOutput = renderProcessor(fresh, laterInput, blockSize);
+
+    float maxDifference = 0;
+    for (int channel = 0; channel < 2; ++channel) {
+        const float* switchedData = switchedOutput.getReadPointer(channel, lastSwitch);
+        const float* freshData = freshOutput.getReadPointer(channel);
+        for (int n = crossfadeLength; n < laterInput.getNumSamples(); ++n) {
+            maxDifference = juce::jmax(maxDifference, std::abs(switchedData[n] - freshData[n]));
+        }
+    }
+    if (maxDifference > 0) {
+        fail("My Reverb switched back to after its fade-out differs from a fresh one by up to " + juce::String(maxDifference));
+    }
+
+    // away and back before a single sample was faded: nothing to fade, My Reverb carries on
+    CompSoundFinalProjectAudioProcessor untouched;
+    setSettingValue(untouched.apvts, juce::String(MODE), 1.0f);
+    untouched.prepareToPlay(sampleRate, blockSize);
+    const juce::AudioBuffer<float> untouchedOutput = renderProcessor(untouched, input, blockSize);
+
+    CompSoundFinalProjectAudioProcessor switchedBack;
+    setSettingValue(switchedBack.apvts, juce::String(MODE), 1.0f);
+    switchedBack.prepareToPlay(sampleRate, blockSize);
+    const juce::AudioBuffer<float> switchedBackOutput = renderProcessor(switchedBack, input, blockSize, { { 20, 0, true }, { 20, 1, false } });
+
+    const float switchBackDifference = getMaxDifference(untouchedOutput, switchedBackOutput, 0, numSamples);
+    if (switchBackDifference > 0) {
+        fail("switching away and straight back changed My Reverb by up to " + juce::String(switchBackDifference));
+    }
+}
+
+void checkBatchedAgainstProcessor() {
+    const double sampleRate = 48000;
+    const int blockSize = 512;
+    const juce::AudioBuffer<float> input = makeNoise(2, 100 * blockSize);
+
+    // the defaults, then everything BatchedReverb does its own way: reverse,
+    // all diffusion steps, freeze, the shortest feedback loops and full damping
+    const std::vector<ParameterValues> cases {
+        { { juce::String(MODE), 1.0f } },
+        { { juce::String(MODE), 1.0f }, { juce::String(REVERSE), 1.0f }, { juce::String(DIFFUSION), 8.0f },
+          { juce::String(FREEZE_MODE), 1.0f }, { juce::String(DELAY_LENGTH), 0.0f },
+          { juce::String(DAMPING), 1.0f }, { juce::String(DAMPING_FREQ), 300.0f } }
+    };
+
+    for (size_t i = 0; i < cases.size(); ++i) {
+        CompSoundFinalProjectAudioProcessor processor;
+        setParameters(processor, cases[i]);
+        processor.prepareToPlay(sampleRate, blockSize);
+        const juce::AudioBuffer<float> processorOutput = renderProcessor(processor, input, blockSize);
+
+        BatchedReverb batched(1);
+        batched.setSettings(0, getSettings(processor.apvts));
+        batched.prepare(sampleRate, blockSize);
+        const juce::AudioBuffer<float> batchedOutput = renderLanes(batched, input, 0, blockSize);
+
+        const float maxDifference = getMaxDifference(processorOutput, batchedOutput, 0, input.getNumSamples());
+        if (! (maxDifference < MAX_ENGINE_DIFFERENCE)) {
+            fail("BatchedReverb differs from the processor by up to " + juce::String(maxDifference)
+                 + " in case " + juce::String(static_cast<int>(i) + 1));
+        }
+    }
+}
+
+void checkLanes(const Settings& defaults) {
+    juce::ScopedNoDenormals noDenormals;
+    const int numLanes = 8;
+    const double sampleRate = 48000;
+    // not a multiple of any register width, so the kernels run their tails
+    const int blockSize = 250;
+    const juce::AudioBuffer<float> input = makeNoise(2 * numLanes, 200 * blockSize);
+
+    // every lane different in everything that is set per lane; delayLength and reverse are shared
+    std::vector<Settings> laneSettings;
+    for (int lane = 0; lane < numLanes; ++lane) {
+        Settings settings = defaults;
+        settings.mode = 1;
+        settings.gain = 0.5f + 0.05f * static_cast<float>(lane);
+        settings.wetLevel = 0.3f + 0.05f * static_cast<float>(lane);
+        settings.earlyReflections = 0.2f + 0.01f * static_cast<float>(lane);
+        settings.diffusion = static_cast<float>(lane % (MAX_DIFFUSION_STEPS + 1));
+        settings.decay = lane % 3 == 0 ? 1.0f : 0.5f;
+        settings.freezeMode = lane == 5;
+        settings.damping = 0.1f * static_cast<float>(lane);
+        settings.dampingFreq = 500.0f + 300.0f * static_cast<float>(lane);
+        laneSettings.push_back(settings);
+    }
+
+    BatchedReverb batched(numLanes);
+    for (int lane = 0; lane < numLanes; ++lane) {
+        batched.setSettings(lane, laneSettings[static_cast<size_t>(lane)]);
+    }
+    batched.prepare(sampleRate, blockSize);
+    const juce::AudioBuffer<float> batchedOutput = renderLanes(batched, input, 0, blockSize);
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        BatchedReverb single(1);
+        single.setSettings(0, laneSettings[static_cast<size_t>(lane)]);
+        single.prepare(sampleRate, blockSize);
+        const juce::AudioBuffer<float> singleOutput = renderLanes(single, input, 2 * lane, blockSize);
+
+        for (int channel = 0; channel < 2; ++channel) {
+            const size_t numBytes = sizeof(float) * static_cast<size_t>(input.getNumSamples());
+            if (std::memcmp(singleOutput.getReadPointer(channel), batchedOutput.getReadPointer(2 * lane + channel), numBytes) != 0) {
+                fail("lane " + juce::String(lane) + " of " + juce::String(numLanes) + " differs from the same stem on its own ("
+                     + (channel == 0 ? "left" : "right") + ", " + getDSPKernels().name + " kernels)");
+            }
+        }
+    }
+}
+
+void benchLanes(const Settings& defaults) {
+    juce::ScopedNoDenormals noDenormals;
+    const double sampleRate = 48000;
+    const int blockSize = 512;
+    const int numBlocks = 1000;
+
+    Settings settings = defaults;
+    settings.mode = 1;
+
+    std::cout << getDSPKernels().name << " kernels, " << numBlocks << " blocks of " << blockSize << " at " << sampleRate << " Hz" << std::endl;
+    double singleLaneMicroseconds = 0;
+    for (const int numLanes : { 1, 4, 8, 16 }) {
+        BatchedReverb reverb(numLanes);
+        for (int lane = 0; lane < numLanes; ++lane) {
+            reverb.setSettings(lane, settings);
+        }
+        reverb.prepare(sampleRate, blockSize);
+
+        const juce::AudioBuffer<float> noise = makeNoise(2 * numLanes, blockSize);
+        juce::AudioBuffer<float> block(2 * numLanes, blockSize);
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        for (int i = 0; i < numBlocks; ++i) {
+            block.makeCopyOf(noise, true);
+            reverb.process(block);
+        }
+        const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - start;
+
+        const double microseconds = elapsedMs * 1000.0 / numBlocks / numLanes;
+        if (numLanes == 1) {
+            singleLaneMicroseconds = microseconds;
+        }
+        std::cout << juce::String(numLanes).paddedLeft(' ', 2) << " lanes: "
+                  << juce::String(microseconds, 1) << " us per stem per block, "
+                  << juce::String(singleLaneMicroseconds / microseconds, 2) << "x faster per stem than 1 lane" << std::endl;
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    bool bench = false;
+    for (int i = 1; i < argc; ++i) {
+        if (juce::String(argv[i]) == "--bench") {
+            bench = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    CompSoundFinalProjectAudioProcessor processor;
+    const juce::NormalisableRange<float> preDelayRange = processor.apvts.getParameterRange(DELAY_LENGTH);
+    const Settings defaults = getSettings(processor.apvts);
+
+    checkSeeds(preDelayRange);
+    checkDelays(preDelayRange);
+    checkLanes(defaults);
+    checkBatchedAgainstProcessor();
+    checkModeSwitching();
+
+    if (bench) {
+        benchLanes(defaults);
+    }
+
+    if (numFailures > 0) {
+        std::cerr << numFailures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
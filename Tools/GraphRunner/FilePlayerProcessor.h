@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    FilePlayerProcessor.h
+
+    Built-in stand-in for platform file players (e.g. Apple's AUAudioFilePlayer)
+    so saved graphs run anywhere. Plays a preloaded buffer once from the start
+    of every prepareToPlay, then outputs silence.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class FilePlayerProcessor  : public juce::AudioProcessor
+{
+public:
+    explicit FilePlayerProcessor(const juce::AudioBuffer<float>& audioToPlay)
+        : AudioProcessor(BusesProperties().withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+          audio(audioToPlay)
+    {
+    }
+
+    //==============================================================================
+    void prepareToPlay(double, int) override {
+        position = 0;
+    }
+
+    void releaseResources() override {}
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override {
+        const int bufferLength = buffer.getNumSamples();
+        const int available = static_cast<int>(juce::jlimit<juce::int64>(0, bufferLength, audio.getNumSamples() - position));
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+            if (available > 0) {
+                buffer.copyFrom(channel, 0, audio, channel % audio.getNumChannels(), static_cast<int>(position), available);
+            }
+            buffer.clear(channel, available, bufferLength - available);
+        }
+
+        position += bufferLength;
+    }
+
+    //==============================================================================
+    const juce::String getName() const override { return "File Player"; }
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    const juce::AudioBuffer<float>& audio;
+    juce::int64 position { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilePlayerProcessor)
+};
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    FilterGraphLoader.cpp
+
+  ==============================================================================
+*/
+
+#include "FilterGraphLoader.h"
+#include "FilePlayerProcessor.h"
+#include "PluginProcessor.h"
+
+namespace {
+
+using IOProcessor = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+
+std::unique_ptr<juce::AudioProcessor> createInternalProcessor(const juce::String& name) {
+    if (name.equalsIgnoreCase("Audio Input")) return std::make_unique<IOProcessor>(IOProcessor::audioInputNode);
+    if (name.equalsIgnoreCase("Audio Output")) return std::make_unique<IOProcessor>(IOProcessor::audioOutputNode);
+    if (name.equalsIgnoreCase("Midi Input")) return std::make_unique<IOProcessor>(IOProcessor::midiInputNode);
+    if (name.equalsIgnoreCase("Midi Output")) return std::make_unique<IOProcessor>(IOProcessor::midiOutputNode);
+    return nullptr;
+}
+
+std::unique_ptr<juce::AudioProcessor> createSubstituteProcessor(const juce::XmlElement& plugin, const juce::AudioBuffer<float>& playerAudio) {
+    if (plugin.getStringAttribute("name") == JucePlugin_Name) {
+        return std::make_unique<CompSoundFinalProjectAudioProcessor>();
+    }
+
+    if (plugin.getIntAttribute("numInputs") == 0 && plugin.getIntAttribute("numOutputs") > 0) {
+        return std::make_unique<FilePlayerProcessor>(playerAudio);
+    }
+
+    return nullptr;
+}
+
+}
+
+juce::Result loadFilterGraph(const juce::File& graphFile,
+                             juce::AudioProcessorGraph& graph,
+                             const juce::AudioBuffer<float>& playerAudio,
+                             std::vector<LoadedGraphNode>& nodes) {
+    const auto xml = juce::parseXML(graphFile);
+    if (xml == nullptr || ! xml->hasTagName("FILTERGRAPH")) {
+        return juce::Result::fail(graphFile.getFileName() + " is not a filter graph");
+    }
+
+    graph.clear();
+    nodes.clear();
+
+    for (auto* filter : xml->getChildWithTagNameIterator("FILTER")) {
+        const auto* plugin = filter->getChildByName("PLUGIN");
+        if (plugin == nullptr) {
+            continue;
+        }
+
+        LoadedGraphNode node;
+        node.nodeID = juce::AudioProcessorGraph::NodeID(static_cast<juce::uint32>(filter->getIntAttribute("uid")));
+        node.savedName = plugin->getStringAttribute("name");
+        node.savedFormat = plugin->getStringAttribute("format");
+
+        std::unique_ptr<juce::AudioProcessor> processor;
+        if (node.savedFormat == "Internal") {
+            processor = createInternalProcessor(node.savedName);
+        } else if (auto substitute = createSubstituteProcessor(*plugin, playerAudio)) {
+            // saved plugin state is format specific (VST3/AU chunks), so substitutes start from defaults
+            auto timed = std::make_unique<TimedProcessor>(std::move(substitute));
+            node.timing = timed.get();
+            processor = std::move(timed);
+        }
+
+        if (processor == nullptr) {
+            return juce::Result::fail("No built-in substitute for " + node.savedFormat + " plugin \"" + node.savedName + "\"");
+        }
+
+        if (graph.addNode(std::move(processor), node.nodeID) == nullptr) {
+            return juce::Result::fail("Could not add node " + juce::String(node.nodeID.uid));
+        }
+
+        nodes.push_back(node);
+    }
+
+    for (auto* connection : xml->getChildWithTagNameIterator("CONNECTION")) {
+        const juce::AudioProcessorGraph::Connection graphConnection {
+            { juce::AudioProcessorGraph::NodeID(static_cast<juce::uint32>(connection->getIntAttribute("srcFilter"))),
+              connection->getIntAttribute("srcChannel") },
+            { juce::AudioProcessorGraph::NodeID(static_cast<juce::uint32>(connection->getIntAttribute("dstFilter"))),
+              connection->getIntAttribute("dstChannel") }
+        };
+
+        if (! graph.addConnection(graphConnection)) {
+            return juce::Result::fail("Could not connect node " + juce::String(graphConnection.source.nodeID.uid)
+                                      + " to node " + juce::String(graphConnection.destination.nodeID.uid));
+        }
+    }
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    FilterGraphLoader.h
+
+    Loads the AudioPluginHost's .filtergraph files (e.g. PlugInHost.filtergraph)
+    into a juce::AudioProcessorGraph without scanning or loading plugins:
+      - Internal I/O nodes become AudioGraphIOProcessors
+      - CompSoundFinalProject is built in directly, whatever format was saved
+      - plugins without inputs (file players, generators) become a FilePlayerProcessor
+    Every non-I/O node is wrapped in a TimedProcessor for per-node timing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TimedProcessor.h"
+
+struct LoadedGraphNode {
+    juce::AudioProcessorGraph::NodeID nodeID;
+    // as saved in the graph file
+    juce::String savedName;
+    juce::String savedFormat;
+    // what actually runs, nullptr for I/O nodes
+    TimedProcessor* timing { nullptr };
+};
+
+// the graph's channel configuration has to be set first, the I/O nodes take theirs from it
+juce::Result loadFilterGraph(const juce::File& graphFile,
+                             juce::AudioProcessorGraph& graph,
+                             const juce::AudioBuffer<float>& playerAudio,
+                             std::vector<LoadedGraphNode>& nodes);
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    Renders a saved AudioPluginHost graph offline and reports its CPU cost,
+    for the whole graph and for every node.
+
+    CompSoundGraph <graph.filtergraph> <audio file> [--output file.wav]
+                   [--block N] [--tail seconds] [--runs N] [--set "Parameter Name=value"]...
+
+    e.g. CompSoundGraph PlugInHost.filtergraph Music/barnard.mp3 --runs 5
+
+    The audio file is what the graph's file player plays. Settings are applied
+    to every CompSoundFinalProject node.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "PluginProcessor.h"
+#include "FilterGraphLoader.h"
+
+namespace {
+
+void printUsage() {
+    std::cout << "usage: CompSoundGraph <graph.filtergraph> <audio file> [--output file.wav]" << std::endl
+              << "                      [--block N] [--tail seconds] [--runs N] [--set \"Parameter Name=value\"]..." << std::endl;
+}
+
+juce::String formatMicroseconds(double seconds) {
+    return juce::String(seconds * 1.0e6, 1) + " us";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray positional;
+    juce::StringArray parameterSettings;
+    juce::String outputPath;
+    int blockSize = 512;
+    double tailSeconds = 2.0;
+    int numRuns = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--output" && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--block" && hasValue) {
+            blockSize = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        } else if (arg == "--tail" && hasValue) {
+            tailSeconds = juce::jmax(0.0, juce::String(argv[++i]).getDoubleValue());
+        } else if (arg == "--runs" && hasValue) {
+            numRuns = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        } else if (arg == "--set" && hasValue) {
+            parameterSettings.add(argv[++i]);
+        } else if (arg.startsWith("--")) {
+            printUsage();
+            return 1;
+        } else {
+            positional.add(arg);
+        }
+    }
+
+    if (positional.size() != 2) {
+        printUsage();
+        return 1;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    const auto graphFile = cwd.getChildFile(positional[0]);
+    const auto audioFile = cwd.getChildFile(positional[1]);
+
+    // the file player reads from memory so the timings contain no disk or codec work
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
+    if (reader == nullptr) {
+        std::cerr << "Could not read " << audioFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    const double sampleRate = reader->sampleRate;
+    juce::AudioBuffer<float> playerAudio(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+    reader->read(&playerAudio, 0, playerAudio.getNumSamples(), 0, true, true);
+
+    juce::AudioProcessorGraph graph;
+    graph.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+
+    std::vector<LoadedGraphNode> nodes;
+    const auto loaded = loadFilterGraph(graphFile, graph, playerAudio, nodes);
+    if (loaded.failed()) {
+        std::cerr << loaded.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    for (auto& node : nodes) {
+        if (node.timing == nullptr) {
+            continue;
+        }
+        if (auto* reverb = dynamic_cast<CompSoundFinalProjectAudioProcessor*>(&node.timing->getInner())) {
+            for (const auto& setting : parameterSettings) {
+                const auto name = setting.upToFirstOccurrenceOf("=", false, false).trim();
+                const auto value = setting.fromFirstOccurrenceOf("=", false, false).getFloatValue();
+                if (! setSettingValue(reverb->apvts, name, value)) {
+                    std::cerr << "unknown parameter: " << name << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if (outputPath.isNotEmpty()) {
+        const auto outputFile = cwd.getChildFile(outputPath);
+        outputFile.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+        if (stream != nullptr) {
+            writer.reset(juce::WavAudioFormat().createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0));
+        }
+        if (writer == nullptr) {
+            std::cerr << "Could not write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+        stream.release();
+    }
+
+    const juce::int64 totalSamples = playerAudio.getNumSamples() + static_cast<juce::int64>(tailSeconds * sampleRate);
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midiMessages;
+
+    graph.setNonRealtime(true);
+
+    double graphSeconds = 0;
+    double maxBlockSeconds = 0;
+    juce::int64 numBlocks = 0;
+
+    for (int run = 0; run < numRuns; ++run) {
+        // every run starts from freshly prepared nodes: empty delay lines, file player at the top
+        graph.prepareToPlay(sampleRate, blockSize);
+
+        for (juce::int64 position = 0; position < totalSamples; position += blockSize) {
+            const int numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, totalSamples - position));
+            buffer.setSize(2, numSamples, false, false, true);
+            buffer.clear();
+            midiMessages.clear();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            graph.processBlock(buffer, midiMessages);
+            const double blockSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            graphSeconds += blockSeconds;
+            maxBlockSeconds = juce::jmax(maxBlockSeconds, blockSeconds);
+            ++numBlocks;
+
+            if (writer != nullptr && run == 0) {
+                writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+            }
+        }
+
+        graph.releaseResources();
+    }
+    writer.reset();
+
+    const double audioSeconds = static_cast<double>(totalSamples * numRuns) / sampleRate;
+    std::cout << "graph:        " << graphFile.getFileName() << " (" << static_cast<int>(nodes.size()) << " nodes)" << std::endl
+              << "rendered:     " << numRuns << " x " << static_cast<double>(totalSamples) / sampleRate << " s at "
+              << sampleRate << " Hz, " << blockSize << " sample blocks" << std::endl
+              << "whole graph:  " << graphSeconds << " s (" << audioSeconds / juce::jmax(graphSeconds, 1.0e-9) << "x realtime), "
+              << formatMicroseconds(graphSeconds / static_cast<double>(juce::jmax<juce::int64>(1, numBlocks))) << " per block, "
+              << formatMicroseconds(maxBlockSeconds) << " worst block" << std::endl
+              << std::endl;
+
+    double nodeSeconds = 0;
+    for (const auto& node : nodes) {
+        std::cout << "node " << juce::String(node.nodeID.uid).paddedLeft(' ', 3) << "  "
+                  << (node.savedName + " (" + node.savedFormat + ")").paddedRight(' ', 40);
+
+        if (node.timing == nullptr) {
+            std::cout << "i/o" << std::endl;
+            continue;
+        }
+
+        const double seconds = node.timing->getProcessSeconds();
+        nodeSeconds += seconds;
+        std::cout << "-> " << node.timing->getName().paddedRight(' ', 24)
+                  << juce::String(seconds, 4) << " s  "
+                  << juce::String(100.0 * seconds / juce::jmax(graphSeconds, 1.0e-9), 1) << "%  "
+                  << formatMicroseconds(seconds / static_cast<double>(juce::jmax<juce::int64>(1, node.timing->getNumBlocks()))) << " per block, "
+                  << formatMicroseconds(node.timing->getMaxBlockSeconds()) << " worst" << std::endl;
+    }
+
+    std::cout << "graph overhead (routing, buffer copies, i/o nodes): " << juce::String(graphSeconds - nodeSeconds, 4) << " s" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    TimedProcessor.h
+
+    Wraps a graph node's processor and measures the time spent in its
+    processBlock, which AudioProcessorGraph does not report per node.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class TimedProcessor  : public juce::AudioProcessor
+{
+public:
+    explicit TimedProcessor(std::unique_ptr<juce::AudioProcessor> processorToTime)
+        : AudioProcessor(getBusesPropertiesOf(*processorToTime)),
+          inner(std::move(processorToTime))
+    {
+    }
+
+    juce::AudioProcessor& getInner() { return *inner; }
+
+    double getProcessSeconds() const { return processSeconds; }
+    double getMaxBlockSeconds() const { return maxBlockSeconds; }
+    juce::int64 getNumBlocks() const { return numBlocks; }
+
+    void resetTiming() {
+        processSeconds = 0;
+        maxBlockSeconds = 0;
+        numBlocks = 0;
+    }
+
+    //==============================================================================
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override {
+        inner->setBusesLayout(getBusesLayout());
+        inner->setRateAndBufferSizeDetails(sampleRate, samplesPerBlock);
+        inner->prepareToPlay(sampleRate, samplesPerBlock);
+    }
+
+    void releaseResources() override { inner->releaseResources(); }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override {
+        const auto start = juce::Time::getHighResolutionTicks();
+        inner->processBlock(buffer, midiMessages);
+        const double blockSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        processSeconds += blockSeconds;
+        maxBlockSeconds = juce::jmax(maxBlockSeconds, blockSeconds);
+        ++numBlocks;
+    }
+
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override {
+        return inner->checkBusesLayoutSupported(layouts);
+    }
+
+    void setNonRealtime(bool isNonRealtime) noexcept override {
+        AudioProcessor::setNonRealtime(isNonRealtime);
+        inner->setNonRealtime(isNonRealtime);
+    }
+
+    //==============================================================================
+    const juce::String getName() const override { return inner->getName(); }
+    double getTailLengthSeconds() const override { return inner->getTailLengthSeconds(); }
+    bool acceptsMidi() const override { return inner->acceptsMidi(); }
+    bool producesMidi() const override { return inner->producesMidi(); }
+
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return inner->getNumPrograms(); }
+    int getCurrentProgram() override { return inner->getCurrentProgram(); }
+    void setCurrentProgram(int index) override { inner->setCurrentProgram(index); }
+    const juce::String getProgramName(int index) override { return inner->getProgramName(index); }
+    void changeProgramName(int index, const juce::String& newName) override { inner->changeProgramName(index, newName); }
+
+    void getStateInformation(juce::MemoryBlock& destData) override { inner->getStateInformation(destData); }
+    void setStateInformation(const void* data, int sizeInBytes) override { inner->setStateInformation(data, sizeInBytes); }
+
+private:
+    static BusesProperties getBusesPropertiesOf(const juce::AudioProcessor& processor) {
+        BusesProperties properties;
+        for (const bool isInput : { true, false }) {
+            for (int i = 0; i < processor.getBusCount(isInput); ++i) {
+                const auto* bus = processor.getBus(isInput, i);
+                properties.addBus(isInput, bus->getName(), bus->getDefaultLayout(), bus->isEnabledByDefault());
+            }
+        }
+        return properties;
+    }
+
+    std::unique_ptr<juce::AudioProcessor> inner;
+    double processSeconds { 0 };
+    double maxBlockSeconds { 0 };
+    juce::int64 numBlocks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimedProcessor)
+};
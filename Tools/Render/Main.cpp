@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    Renders an audio file through the reverb without a plugin host.
+
+    CompSoundRender <input> <output> [--block N] [--fifo N] [--tail seconds]
+                    [--bits N] [--batch K] [--seed N] [--set "Parameter Name=value"]...
+
+    e.g. CompSoundRender Music/barnard.mp3 barnard_wet.wav --set "Mode=1" --set "Decay Rate=0.9"
+
+    --batch K renders a file of K stereo stems (exactly 2K channels,
+    channels 2k and 2k + 1 are stem k) through one BatchedReverb with K lanes instead, always running
+    "My Reverb" with the same settings on every stem.
+
+    --seed N picks a different "My Reverb" delay network. The same seed,
+    settings and input always render the same output.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "BatchedReverb.h"
+#include "PluginProcessor.h"
+#include "StreamingRenderer.h"
+
+namespace {
+
+void printUsage() {
+    std::cout << "usage: CompSoundRender <input> <output> [--block N] [--fifo N] [--tail seconds]" << std::endl
+              << "                       [--bits N] [--batch K] [--seed N] [--set \"Parameter Name=value\"]..." << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray positional;
+    juce::StringArray parameterSettings;
+    RenderOptions options;
+    int batchLanes = 0;
+    juce::int64 topologySeed = DEFAULT_TOPOLOGY_SEED;
+
+    for (int i = 1; i < argc; ++i) {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--block" && hasValue) {
+            options.blockSize = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        } else if (arg == "--fifo" && hasValue) {
+            options.fifoBlocks = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        } else if (arg == "--tail" && hasValue) {
+            options.tailSeconds = juce::jmax(0.0, juce::String(argv[++i]).getDoubleValue());
+        } else if (arg == "--bits" && hasValue) {
+            options.bitsPerSample = juce::String(argv[++i]).getIntValue();
+        } else if (arg == "--batch" && hasValue) {
+            batchLanes = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        } else if (arg == "--seed" && hasValue) {
+            topologySeed = juce::String(argv[++i]).getLargeIntValue();
+        } else if (arg == "--set" && hasValue) {
+            parameterSettings.add(argv[++i]);
+        } else if (arg.startsWith("--")) {
+            printUsage();
+            return 1;
+        } else {
+            positional.add(arg);
+        }
+    }
+
+    if (positional.size() != 2) {
+        printUsage();
+        return 1;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    const auto inputFile = cwd.getChildFile(positional[0]);
+    const auto outputFile = cwd.getChildFile(positional[1]);
+
+    CompSoundFinalProjectAudioProcessor processor;
+    processor.setTopologySeed(topologySeed);
+    for (const auto& setting : parameterSettings) {
+        const auto name = setting.upToFirstOccurrenceOf("=", false, false).trim();
+        const auto value = setting.fromFirstOccurrenceOf("=", false, false).getFloatValue();
+        if (! setSettingValue(processor.apvts, name, value)) {
+            std::cerr << "unknown parameter: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    // the plugin instance still owns the parameters, the batch takes its settings from it
+    std::unique_ptr<BatchedReverbProcessor> batchedProcessor;
+    if (batchLanes > 0) {
+        batchedProcessor = std::make_unique<BatchedReverbProcessor>(batchLanes);
+        batchedProcessor->setTopologySeed(topologySeed);
+        batchedProcessor->setSettings(getSettings(processor.apvts));
+    }
+
+    juce::AudioProcessor& renderProcessor = batchedProcessor != nullptr ? static_cast<juce::AudioProcessor&>(*batchedProcessor)
+                                                                        : static_cast<juce::AudioProcessor&>(processor);
+
+    StreamingRenderer renderer(renderProcessor, options);
+    RenderStats stats;
+    const auto result = renderer.render(inputFile, outputFile, stats);
+
+    if (result.failed()) {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    const double audioSeconds = static_cast<double>(stats.samplesRendered) / stats.sampleRate;
+    if (batchedProcessor != nullptr) {
+        std::cout << "batch:        " << batchLanes << " stereo stems, " << getDSPKernels().name << " kernels" << std::endl;
+    }
+    std::cout << "input:        " << inputFile.getFileName() << (stats.memoryMappedInput ? " (memory-mapped)" : " (decoded)") << std::endl
+              << "rendered:     " << audioSeconds << " s of audio in " << stats.wallSeconds << " s" << std::endl
+              << "dsp:          " << stats.dspSeconds << " s (" << audioSeconds / juce::jmax(stats.dspSeconds, 1.0e-9) << "x realtime)" << std::endl
+              << "input stall:  " << stats.inputStallSeconds << " s" << std::endl
+              << "output stall: " << stats.outputStallSeconds << " s" << std::endl;
+
+    return 0;
+}
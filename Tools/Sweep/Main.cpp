@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+    Renders many combinations of the reverb's settings in parallel and writes
+    one CSV row of measurements per combination.
+
+    CompSoundSweep --csv results.csv [--grid N | --random N] [--seed N]
+                   [--input file] [--ir-seconds S] [--rate Hz] [--block N]
+                   [--threads N] [--audio-dir dir] [--set "Parameter Name=value"]...
+
+    --grid N     every combination of N evenly spaced values per swept parameter (default 3)
+    --random N   N combinations drawn uniformly from the parameter ranges
+    --input      program material for centroid / peak / CPU; without it those
+                 are measured on the impulse response
+    --audio-dir  also write every rendered file there
+    --set        fixed values for parameters that are not swept
+
+    Basic Reverb (Mode 0) ignores Diffusion, Decay Rate, Damping Frequency
+    Cutoff and Pre-Delay, so its combinations only sweep Damping; those
+    columns are left empty in its rows.
+
+    Every combination gets its own processor instance, so renders share no state.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include <set>
+#include "PluginProcessor.h"
+#include "RenderMetrics.h"
+#include "WorkStealingPool.h"
+
+namespace {
+
+const juce::StringArray sweptParameters {
+    juce::String(MODE),
+    juce::String(DIFFUSION),
+    juce::String(DECAY),
+    juce::String(DAMPING),
+    juce::String(DAMPING_FREQ),
+    juce::String(DELAY_LENGTH)
+};
+
+// swept parameters that only "My Reverb" uses, juce::dsp::Reverb (Mode 0) has no equivalent
+const juce::StringArray myReverbOnlyParameters {
+    juce::String(DIFFUSION),
+    juce::String(DECAY),
+    juce::String(DAMPING_FREQ),
+    juce::String(DELAY_LENGTH)
+};
+
+struct SweepResult {
+    double rt60 { 0 };
+    double centroid { 0 };
+    float peakDecibels { 0 };
+    double cpuSeconds { 0 };
+    double audioSeconds { 0 };
+    juce::String audioFile;
+    juce::String error;
+};
+
+void printUsage() {
+    std::cout << "usage: CompSoundSweep --csv results.csv [--grid N | --random N] [--seed N]" << std::endl
+              << "                      [--input file] [--ir-seconds S] [--rate Hz] [--block N]" << std::endl
+              << "                      [--threads N] [--audio-dir dir] [--set \"Parameter Name=value\"]..." << std::endl;
+}
+
+std::vector<std::vector<float>> makeGrid(const std::vector<juce::NormalisableRange<float>>& ranges, int steps) {
+    // values along each parameter, snapped so integer parameters don't repeat
+    std::vector<std::vector<float>> axes;
+    for (const auto& range : ranges) {
+        std::vector<float> axis;
+        for (int i = 0; i < steps; ++i) {
+            const float proportion = steps > 1 ? static_cast<float>(i) / static_cast<float>(steps - 1) : 0.0f;
+            const float value = range.snapToLegalValue(range.convertFrom0to1(proportion));
+            if (axis.empty() || ! juce::approximatelyEqual(axis.back(), value)) {
+                axis.push_back(value);
+            }
+        }
+        axes.push_back(axis);
+    }
+
+    std::vector<std::vector<float>> combinations;
+    std::vector<size_t> digits(axes.size(), 0);
+    for (;;) {
+        std::vector<float> combination;
+        for (size_t p = 0; p < axes.size(); ++p) {
+            combination.push_back(axes[p][digits[p]]);
+        }
+        combinations.push_back(combination);
+
+        size_t p = 0;
+        while (p < axes.size() && ++digits[p] == axes[p].size()) {
+            digits[p++] = 0;
+        }
+        if (p == axes.size()) {
+            break;
+        }
+    }
+
+    return combinations;
+}
+
+std::vector<std::vector<float>> makeRandom(const std::vector<juce::NormalisableRange<float>>& ranges, int count, juce::int64 seed) {
+    juce::Random random(seed);
+    std::vector<std::vector<float>> combinations;
+    for (int i = 0; i < count; ++i) {
+        std::vector<float> combination;
+        for (const auto& range : ranges) {
+            combination.push_back(range.snapToLegalValue(range.convertFrom0to1(random.nextFloat())));
+        }
+        combinations.push_back(combination);
+    }
+    return combinations;
+}
+
+// clears the parameters Mode 0 ignores to NaN (meaning "not set") and drops
+// the combinations that become repeats, so every row renders something new
+std::vector<std::vector<float>> collapseUnusedParameters(const std::vector<std::vector<float>>& combinations) {
+    const int modeIndex = sweptParameters.indexOf(juce::String(MODE));
+
+    std::vector<std::vector<float>> collapsed;
+    std::set<juce::String> seen;
+    for (auto combination : combinations) {
+        juce::StringArray key;
+        for (size_t p = 0; p < combination.size(); ++p) {
+            const auto& parameterID = sweptParameters[static_cast<int>(p)];
+            if (static_cast<int>(combination[static_cast<size_t>(modeIndex)]) == 0 && myReverbOnlyParameters.contains(parameterID)) {
+                combination[p] = std::numeric_limits<float>::quiet_NaN();
+            }
+            key.add(std::isnan(combination[p]) ? juce::String("-") : juce::String(combination[p]));
+        }
+
+        if (seen.insert(key.joinIntoString(",")).second) {
+            collapsed.push_back(combination);
+        }
+    }
+    return collapsed;
+}
+
+// processes audio in place in blocks, returns the time spent in processBlock
+double renderInPlace(juce::AudioProcessor& processor, juce::AudioBuffer<float>& audio, double sampleRate, int blockSize) {
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(audio.getNumChannels(), audio.getNumChannels(), sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::MidiBuffer midiMessages;
+    double seconds = 0;
+
+    for (int position = 0; position < audio.getNumSamples(); position += blockSize) {
+        const int numSamples = juce::jmin(blockSize, audio.getNumSamples() - position);
+
+        float* channels[2];
+        for (int channel = 0; channel < audio.getNumChannels(); ++channel) {
+            channels[channel] = audio.getWritePointer(channel, position);
+        }
+        juce::AudioBuffer<float> block(channels, audio.getNumChannels(), numSamples);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(block, midiMessages);
+        seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        midiMessages.clear();
+    }
+
+    processor.releaseResources();
+    return seconds;
+}
+
+bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio, double sampleRate) {
+    file.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+    if (stream == nullptr) {
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(juce::WavAudioFormat().createWriterFor(stream.get(), sampleRate,
+                                                                                           static_cast<unsigned int>(audio.getNumChannels()),
+                                                                                           24, {}, 0));
+    if (writer == nullptr) {
+        return false;
+    }
+    stream.release();
+
+    return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+}
+
+juce::String csvNumber(double value) {
+    return std::isfinite(value) ? juce::String(value, 4) : juce::String();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::String csvPath, inputPath, audioDirPath;
+    juce::StringArray fixedSettings;
+    int gridSteps = 3;
+    int randomCount = 0;
+    juce::int64 seed = 1;
+    double irSeconds = 4.0;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int numThreads = juce::SystemStats::getNumCpus();
+
+    for (int i = 1; i < argc; ++i) {
+        const juce::String arg(argv[i]);
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const juce::String value(argv[++i]);
+
+        if (arg == "--csv") csvPath = value;
+        else if (arg == "--grid") gridSteps = juce::jmax(1, value.getIntValue());
+        else if (arg == "--random") randomCount = juce::jmax(1, value.getIntValue());
+        else if (arg == "--seed") seed = value.getLargeIntValue();
+        else if (arg == "--input") inputPath = value;
+        else if (arg == "--ir-seconds") irSeconds = juce::jmax(0.1, value.getDoubleValue());
+        else if (arg == "--rate") sampleRate = juce::jmax(8000.0, value.getDoubleValue());
+        else if (arg == "--block") blockSize = juce::jmax(1, value.getIntValue());
+        else if (arg == "--threads") numThreads = juce::jmax(1, value.getIntValue());
+        else if (arg == "--audio-dir") audioDirPath = value;
+        else if (arg == "--set") fixedSettings.add(value);
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (csvPath.isEmpty()) {
+        printUsage();
+        return 1;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    // program material is loaded once and only ever read by the workers
+    juce::AudioBuffer<float> programAudio;
+    if (inputPath.isNotEmpty()) {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(cwd.getChildFile(inputPath)));
+        if (reader == nullptr) {
+            std::cerr << "Could not read " << inputPath << std::endl;
+            return 1;
+        }
+        sampleRate = reader->sampleRate;
+        programAudio.setSize(2, static_cast<int>(reader->lengthInSamples));
+        reader->read(&programAudio, 0, programAudio.getNumSamples(), 0, true, true);
+    }
+
+    juce::File audioDir;
+    if (audioDirPath.isNotEmpty()) {
+        audioDir = cwd.getChildFile(audioDirPath);
+        audioDir.createDirectory();
+    }
+
+    // parameter ranges come from the plugin's own layout
+    std::vector<juce::NormalisableRange<float>> ranges;
+    {
+        CompSoundFinalProjectAudioProcessor reference;
+        for (const auto& parameterID : sweptParameters) {
+            ranges.push_back(reference.apvts.getParameterRange(parameterID));
+        }
+    }
+
+    const auto combinations = collapseUnusedParameters(randomCount > 0 ? makeRandom(ranges, randomCount, seed)
+                                                                       : makeGrid(ranges, gridSteps));
+    const int numJobs = static_cast<int>(combinations.size());
+    std::vector<SweepResult> results(combinations.size());
+    std::atomic<int> jobsDone { 0 };
+
+    WorkStealingPool pool(numThreads);
+    std::cout << "rendering " << numJobs << " combinations on " << pool.getNumThreads() << " threads" << std::endl;
+
+    const auto sweepStart = juce::Time::getHighResolutionTicks();
+
+    pool.run(numJobs, [&](int jobIndex, int) {
+        auto& result = results[static_cast<size_t>(jobIndex)];
+        const auto& combination = combinations[static_cast<size_t>(jobIndex)];
+
+        CompSoundFinalProjectAudioProcessor processor;
+        for (const auto& setting : fixedSettings) {
+            if (! setSettingValue(processor.apvts,
+                                  setting.upToFirstOccurrenceOf("=", false, false).trim(),
+                                  setting.fromFirstOccurrenceOf("=", false, false).getFloatValue())) {
+                result.error = "unknown parameter in " + setting;
+            }
+        }
+        for (size_t p = 0; p < combination.size(); ++p) {
+            if (! std::isnan(combination[p])) {
+                setSettingValue(processor.apvts, sweptParameters[static_cast<int>(p)], combination[p]);
+            }
+        }
+
+        // impulse response for RT60
+        juce::AudioBuffer<float> impulseResponse(2, static_cast<int>(irSeconds * sampleRate));
+        impulseResponse.clear();
+        impulseResponse.setSample(0, 0, 1.0f);
+        impulseResponse.setSample(1, 0, 1.0f);
+        const double irCpuSeconds = renderInPlace(processor, impulseResponse, sampleRate, blockSize);
+        result.rt60 = measureRT60(impulseResponse, sampleRate);
+
+        const juce::AudioBuffer<float>* measured = &impulseResponse;
+        juce::AudioBuffer<float> program;
+        if (programAudio.getNumSamples() > 0) {
+            program.makeCopyOf(programAudio);
+            result.cpuSeconds = renderInPlace(processor, program, sampleRate, blockSize);
+            measured = &program;
+        } else {
+            result.cpuSeconds = irCpuSeconds;
+        }
+
+        result.audioSeconds = measured->getNumSamples() / sampleRate;
+        result.centroid = measureSpectralCentroid(*measured, sampleRate);
+        result.peakDecibels = measurePeakDecibels(*measured);
+
+        if (audioDir != juce::File()) {
+            const auto file = audioDir.getChildFile("sweep_" + juce::String(jobIndex).paddedLeft('0', 5) + ".wav");
+            if (writeWav(file, *measured, sampleRate)) {
+                result.audioFile = file.getFileName();
+            }
+        }
+
+        const int done = ++jobsDone;
+        if (done % 50 == 0 || done == numJobs) {
+            std::cout << done << " / " << numJobs << std::endl;
+        }
+    });
+
+    const double sweepSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - sweepStart);
+
+    juce::StringArray lines;
+    {
+        juce::StringArray header { "index" };
+        for (const auto& parameterID : sweptParameters) {
+            header.add(parameterID.quoted());
+        }
+        header.addArray(juce::StringArray { "rt60_s", "centroid_hz", "peak_dbfs", "cpu_s", "realtime_factor", "audio_file", "error" });
+        lines.add(header.joinIntoString(","));
+    }
+
+    for (int jobIndex = 0; jobIndex < numJobs; ++jobIndex) {
+        const auto& result = results[static_cast<size_t>(jobIndex)];
+        juce::StringArray row { juce::String(jobIndex) };
+        for (const float value : combinations[static_cast<size_t>(jobIndex)]) {
+            row.add(std::isnan(value) ? juce::String() : juce::String(value));
+        }
+        row.add(csvNumber(result.rt60));
+        row.add(csvNumber(result.centroid));
+        row.add(csvNumber(result.peakDecibels));
+        row.add(csvNumber(result.cpuSeconds));
+        row.add(csvNumber(result.audioSeconds / juce::jmax(result.cpuSeconds, 1.0e-9)));
+        row.add(result.audioFile);
+        row.add(result.error.quoted());
+        lines.add(row.joinIntoString(","));
+    }
+
+    const auto csvFile = cwd.getChildFile(csvPath);
+    if (! csvFile.replaceWithText(lines.joinIntoString("\n") + "\n")) {
+        std::cerr << "Could not write " << csvFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "done in " << sweepSeconds << " s, results in " << csvFile.getFullPathName() << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    RenderMetrics.cpp
+
+  ==============================================================================
+*/
+
+#include "RenderMetrics.h"
+
+namespace {
+
+const int CENTROID_FFT_ORDER = 11;
+
+// first sample where the energy decay curve has dropped by the given amount, -1 if never
+int findDecayPoint(const std::vector<double>& energyDecay, double decibels) {
+    const double threshold = energyDecay[0] * std::pow(10.0, decibels / 10.0);
+    for (size_t i = 0; i < energyDecay.size(); ++i) {
+        if (energyDecay[i] <= threshold) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+}
+
+double measureRT60(const juce::AudioBuffer<float>& impulseResponse, double sampleRate) {
+    const int numSamples = impulseResponse.getNumSamples();
+    if (numSamples == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // backward-integrated energy, summed over channels
+    std::vector<double> energyDecay(static_cast<size_t>(numSamples));
+    double remaining = 0;
+    for (int i = numSamples - 1; i >= 0; --i) {
+        for (int channel = 0; channel < impulseResponse.getNumChannels(); ++channel) {
+            const double sample = impulseResponse.getSample(channel, i);
+            remaining += sample * sample;
+        }
+        energyDecay[static_cast<size_t>(i)] = remaining;
+    }
+
+    if (energyDecay[0] <= 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const int start = findDecayPoint(energyDecay, -5.0);
+    const int endT20 = findDecayPoint(energyDecay, -25.0);
+    if (start >= 0 && endT20 > start) {
+        return 3.0 * (endT20 - start) / sampleRate;
+    }
+
+    const int endT10 = findDecayPoint(energyDecay, -15.0);
+    if (start >= 0 && endT10 > start) {
+        return 6.0 * (endT10 - start) / sampleRate;
+    }
+
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+double measureSpectralCentroid(const juce::AudioBuffer<float>& audio, double sampleRate) {
+    const int fftSize = 1 << CENTROID_FFT_ORDER;
+    const int hopSize = fftSize / 2;
+    const int numBins = fftSize / 2 + 1;
+
+    juce::dsp::FFT fft(CENTROID_FFT_ORDER);
+    juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+
+    std::vector<float> frame(static_cast<size_t>(2 * fftSize));
+    std::vector<double> spectrum(static_cast<size_t>(numBins), 0.0);
+
+    for (int start = 0; start + fftSize <= audio.getNumSamples(); start += hopSize) {
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        for (int channel = 0; channel < audio.getNumChannels(); ++channel) {
+            juce::FloatVectorOperations::add(frame.data(), audio.getReadPointer(channel, start), fftSize);
+        }
+
+        window.multiplyWithWindowingTable(frame.data(), static_cast<size_t>(fftSize));
+        fft.performFrequencyOnlyForwardTransform(frame.data());
+
+        for (int bin = 0; bin < numBins; ++bin) {
+            spectrum[static_cast<size_t>(bin)] += frame[static_cast<size_t>(bin)];
+        }
+    }
+
+    double weighted = 0;
+    double total = 0;
+    for (int bin = 0; bin < numBins; ++bin) {
+        const double frequency = bin * sampleRate / fftSize;
+        weighted += frequency * spectrum[static_cast<size_t>(bin)];
+        total += spectrum[static_cast<size_t>(bin)];
+    }
+
+    return total > 0 ? weighted / total : 0.0;
+}
+
+float measurePeakDecibels(const juce::AudioBuffer<float>& audio) {
+    return juce::Decibels::gainToDecibels(audio.getMagnitude(0, audio.getNumSamples()));
+}
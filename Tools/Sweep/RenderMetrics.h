@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    RenderMetrics.h
+
+    Measurements taken from rendered audio for the parameter sweep.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// RT60 in seconds from an impulse response: Schroeder backward integration,
+// extrapolated from the -5..-25 dB slope (T20), or -5..-15 dB (T10) when the
+// response is too short for T20. NaN when neither is reached.
+double measureRT60(const juce::AudioBuffer<float>& impulseResponse, double sampleRate);
+
+// spectral centroid in Hz of the channel-summed signal, averaged over 2048-point Hann frames
+double measureSpectralCentroid(const juce::AudioBuffer<float>& audio, double sampleRate);
+
+// absolute peak over all channels in dBFS
+float measurePeakDecibels(const juce::AudioBuffer<float>& audio);
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.h
+
+    Runs a batch of independent jobs on a fixed set of threads. Every worker
+    starts with its own contiguous share of the jobs and takes from the back
+    of it; a worker that runs dry steals from the front of the others. Render
+    times vary a lot between settings (diffusion 0 vs 8), so a static split
+    would leave cores idle at the end of the batch.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(int numThreadsToUse)
+        : numThreads(juce::jmax(1, numThreadsToUse))
+    {
+    }
+
+    int getNumThreads() const { return numThreads; }
+
+    // calls job(jobIndex, workerIndex) once for every jobIndex in [0, numJobs), returns when all are done
+    void run(int numJobs, const std::function<void(int jobIndex, int workerIndex)>& job) {
+        std::vector<WorkQueue> queues(static_cast<size_t>(numThreads));
+        for (int worker = 0; worker < numThreads; ++worker) {
+            const int first = static_cast<int>(static_cast<juce::int64>(numJobs) * worker / numThreads);
+            const int last = static_cast<int>(static_cast<juce::int64>(numJobs) * (worker + 1) / numThreads);
+            for (int jobIndex = first; jobIndex < last; ++jobIndex) {
+                queues[static_cast<size_t>(worker)].jobs.push_back(jobIndex);
+            }
+        }
+
+        std::vector<std::thread> threads;
+        for (int worker = 0; worker < numThreads; ++worker) {
+            threads.emplace_back([&queues, &job, worker, this] {
+                int jobIndex;
+                while (takeJob(queues, worker, jobIndex)) {
+                    job(jobIndex, worker);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<int> jobs;
+    };
+
+    bool takeJob(std::vector<WorkQueue>& queues, int worker, int& jobIndex) {
+        {
+            auto& own = queues[static_cast<size_t>(worker)];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (! own.jobs.empty()) {
+                jobIndex = own.jobs.back();
+                own.jobs.pop_back();
+                return true;
+            }
+        }
+
+        // no job ever gets added, so one pass over everybody else finding nothing means we are done
+        for (int offset = 1; offset < numThreads; ++offset) {
+            auto& victim = queues[static_cast<size_t>((worker + offset) % numThreads)];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (! victim.jobs.empty()) {
+                jobIndex = victim.jobs.front();
+                victim.jobs.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const int numThreads;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkStealingPool)
+};